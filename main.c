@@ -39,6 +39,24 @@
  *
  *  ***uint8_t _timeout ( uint8_t min, uint8_t sec, uint8_t ms, 
  *                        void (* func )( void ) );
+ *
+ *  \brief Functions delay_ms() and delay_ticks() implement a blocking delay
+ *         for a given number of milliseconds or fCCU ticks. Durations beyond
+ *         the 48 bit hardware range are extended in software.
+ *  \param ms the number of milliseconds to delay, at least 1
+ *  \param ticks the number of fCCU ticks to delay, at least 1
+ *  \returns 0 upon success, >0 upon error
+ *
+ *  ***uint8_t delay_ms ( uint32_t ms );
+ *  ***uint8_t delay_ticks ( uint64_t ticks );
+ *
+ *  \brief Functions timeout_ms() and timeout_ticks() implement a non-blocking
+ *         delay for a given number of milliseconds or fCCU ticks. After the
+ *         given timeout the callback function func() shall be invoked.
+ *  \returns 0 upon success, >0 upon error
+ *
+ *  ***uint8_t timeout_ms ( uint32_t ms, void (* func )( void ) );
+ *  ***uint8_t timeout_ticks ( uint64_t ticks, void (* func )( void ) );
 */
 
 #include <stdlib.h>
@@ -0,0 +1,12 @@
+/*
+ * GPIO.h
+ *
+ *  Host stub of the board GPIO header.
+ */
+
+#ifndef GPIO_STUB_H_
+#define GPIO_STUB_H_
+
+#include <XMC4500.h>
+
+#endif /* GPIO_STUB_H_ */
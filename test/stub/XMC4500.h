@@ -0,0 +1,127 @@
+/*
+ * XMC4500.h
+ *
+ *  Host stub of the XMC4500 device header. The peripherals are plain memory,
+ *  so the driver can be linked and inspected on the build machine.
+ */
+
+#ifndef XMC4500_STUB_H_
+#define XMC4500_STUB_H_
+
+#include <stdint.h>
+
+#define __IO volatile
+
+/******************************************************************* REGISTER */
+typedef struct {
+	__IO uint32_t GCTRL, GSTAT, GIDLS, GIDLC, GCSS, GCSC, GCST;
+} CCU4_GLOBAL_TypeDef;
+
+typedef struct {
+	__IO uint32_t INS, CMC, TCST, TCSET, TCCLR, TC, PSL, DIT, DITS, PSC, FPC,
+	              FPCS, PR, PRS, CR, CRS, TIMER, C0V, C1V, C2V, C3V, INTS,
+	              INTE, SRS, SWS, SWR;
+} CCU4_CC4_TypeDef;
+
+typedef struct { __IO uint32_t PRSET0, PRCLR0, PRSET1, PRCLR1; } SCU_RESET_TypeDef;
+typedef struct { __IO uint32_t CLKSET, SLEEPCR; } SCU_CLK_TypeDef;
+typedef struct { __IO uint32_t CCUCON; } SCU_GENERAL_TypeDef;
+typedef struct { __IO uint32_t OMR; } PORT1_Type;
+
+extern CCU4_GLOBAL_TypeDef stub_ccu4[4];
+extern CCU4_CC4_TypeDef    stub_cc4[4][4];
+extern SCU_RESET_TypeDef   stub_scu_reset;
+extern SCU_CLK_TypeDef     stub_scu_clk;
+extern SCU_GENERAL_TypeDef stub_scu_general;
+extern PORT1_Type          stub_port1;
+
+#define CCU40           (&stub_ccu4[0])
+#define CCU41           (&stub_ccu4[1])
+#define CCU42           (&stub_ccu4[2])
+#define CCU43           (&stub_ccu4[3])
+#define CCU40_CC40      (&stub_cc4[0][0])
+#define CCU40_CC41      (&stub_cc4[0][1])
+#define CCU40_CC42      (&stub_cc4[0][2])
+#define CCU40_CC43      (&stub_cc4[0][3])
+#define CCU41_CC40      (&stub_cc4[1][0])
+#define CCU41_CC41      (&stub_cc4[1][1])
+#define CCU41_CC42      (&stub_cc4[1][2])
+#define CCU41_CC43      (&stub_cc4[1][3])
+#define CCU42_CC40      (&stub_cc4[2][0])
+#define CCU42_CC41      (&stub_cc4[2][1])
+#define CCU42_CC42      (&stub_cc4[2][2])
+#define CCU42_CC43      (&stub_cc4[2][3])
+#define CCU43_CC40      (&stub_cc4[3][0])
+#define CCU43_CC41      (&stub_cc4[3][1])
+#define CCU43_CC42      (&stub_cc4[3][2])
+#define CCU43_CC43      (&stub_cc4[3][3])
+#define SCU_RESET       (&stub_scu_reset)
+#define SCU_CLK         (&stub_scu_clk)
+#define SCU_GENERAL     (&stub_scu_general)
+#define PORT1           (&stub_port1)
+
+/******************************************************************* BITFIELD */
+#define SCU_RESET_PRSET0_CCU40RS_Pos    2
+#define SCU_RESET_PRSET0_CCU41RS_Pos    3
+#define SCU_RESET_PRSET0_CCU42RS_Pos    4
+#define SCU_RESET_PRSET1_CCU43RS_Pos    0
+#define SCU_RESET_PRCLR0_CCU40RS_Pos    2
+#define SCU_RESET_PRCLR0_CCU41RS_Pos    3
+#define SCU_RESET_PRCLR0_CCU42RS_Pos    4
+#define SCU_RESET_PRCLR1_CCU43RS_Pos    0
+#define SCU_CLK_CLKSET_CCUCEN_Pos       4
+#define SCU_CLK_SLEEPCR_CCUCR_Pos       20
+#define SCU_GENERAL_CCUCON_GSC40_Pos    0
+#define SCU_GENERAL_CCUCON_GSC41_Pos    1
+#define SCU_GENERAL_CCUCON_GSC42_Pos    2
+#define SCU_GENERAL_CCUCON_GSC43_Pos    3
+
+#define CCU4_GIDLS_SS0I_Pos             0
+#define CCU4_GIDLS_SS1I_Pos             1
+#define CCU4_GIDLS_SS2I_Pos             2
+#define CCU4_GIDLS_SS3I_Pos             3
+#define CCU4_GIDLS_CPRB_Pos             8
+#define CCU4_GIDLC_CS0I_Pos             0
+#define CCU4_GIDLC_CS1I_Pos             1
+#define CCU4_GIDLC_CS2I_Pos             2
+#define CCU4_GIDLC_CS3I_Pos             3
+#define CCU4_GIDLC_SPRB_Pos             8
+#define CCU4_GCSS_S0SE_Pos              0
+#define CCU4_GCSS_S0PSE_Pos             2
+#define CCU4_GCSS_S1SE_Pos              4
+#define CCU4_GCSS_S1PSE_Pos             6
+#define CCU4_GCSS_S2SE_Pos              8
+#define CCU4_GCSS_S2PSE_Pos             10
+#define CCU4_GCSS_S3SE_Pos              12
+#define CCU4_GCSS_S3PSE_Pos             14
+#define CCU4_CC4_INS_EV0IS_Pos          0
+#define CCU4_CC4_INS_EV0EM_Pos          16
+#define CCU4_CC4_CMC_STRTS_Pos          0
+#define CCU4_CC4_CMC_TCE_Pos            20
+#define CCU4_CC4_TCST_TRB_Msk           0x01UL
+#define CCU4_CC4_TCSET_TRBS_Pos         0
+#define CCU4_CC4_TCCLR_TRBC_Pos         0
+#define CCU4_CC4_TCCLR_TCC_Pos          1
+#define CCU4_CC4_TC_CLST_Pos            2
+#define CCU4_CC4_PSC_PSIV_Pos           0
+#define CCU4_CC4_TIMER_TVAL_Msk         0xFFFFUL
+#define CCU4_CC4_INTS_PMUS_Pos          0
+#define CCU4_CC4_INTE_PME_Pos           0
+#define CCU4_CC4_SWR_RPM_Pos            0
+
+/*********************************************************************** CMSIS */
+typedef enum {
+	CCU40_0_IRQn, CCU41_0_IRQn, CCU42_0_IRQn, CCU43_0_IRQn, STUB_IRQn_MAX
+} IRQn_Type;
+
+extern uint32_t stub_primask;
+extern uint8_t  stub_irq_enabled[STUB_IRQn_MAX];
+extern uint8_t  stub_irq_pending[STUB_IRQn_MAX];
+
+void     NVIC_EnableIRQ (IRQn_Type irq);
+void     NVIC_ClearPendingIRQ (IRQn_Type irq);
+uint32_t __get_PRIMASK (void);
+void     __set_PRIMASK (uint32_t primask);
+void     __disable_irq (void);
+
+#endif /* XMC4500_STUB_H_ */
@@ -0,0 +1,60 @@
+/*
+ * test_check.h
+ *
+ *  Failure reporting shared by the host tests, and a helper to fake the run
+ *  state of a timer in the register stub, which does not model TCSET/TCCLR.
+ */
+
+#ifndef TEST_CHECK_H_
+#define TEST_CHECK_H_
+
+#include <stdio.h>
+#include <xmc4500_timer_driver.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                           \
+	do {                                                                  \
+		if (!(cond)) {                                                \
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);\
+			failures++;                                           \
+		}                                                             \
+	} while (0)
+
+#define CHECK_MSG(cond, ...)                                                  \
+	do {                                                                  \
+		if (!(cond)) {                                                \
+			printf("FAIL %s:%d: ", __FILE__, __LINE__);           \
+			printf(__VA_ARGS__);                                  \
+			printf("\n");                                         \
+			failures++;                                           \
+		}                                                             \
+	} while (0)
+
+/*
+ * Sets or clears the timer run bit of the first slice of a timer.
+ */
+static inline void test_running (timer_channel_t *channel, _Bool running)
+{
+	//Plain assignments, compound ones on volatile are deprecated in C++20
+	if (running) {
+		channel->slice[0]->TCST = channel->slice[0]->TCST | CCU4_CC4_TCST_TRB_Msk;
+	} else {
+		channel->slice[0]->TCST = channel->slice[0]->TCST & ~CCU4_CC4_TCST_TRB_Msk;
+	}
+}
+
+/*
+ * Prints the summary line and returns the exit code of the test.
+ */
+static inline int test_result (void)
+{
+	if (failures) {
+		printf("%d failures\n", failures);
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
+
+#endif /* TEST_CHECK_H_ */
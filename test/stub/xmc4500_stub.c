@@ -0,0 +1,44 @@
+/*
+ * xmc4500_stub.c
+ *
+ *  Register memory and CMSIS functions of the host stub.
+ */
+
+#include <string.h>
+#include <XMC4500.h>
+
+CCU4_GLOBAL_TypeDef stub_ccu4[4];
+CCU4_CC4_TypeDef    stub_cc4[4][4];
+SCU_RESET_TypeDef   stub_scu_reset;
+SCU_CLK_TypeDef     stub_scu_clk;
+SCU_GENERAL_TypeDef stub_scu_general;
+PORT1_Type          stub_port1;
+
+uint32_t stub_primask;
+uint8_t  stub_irq_enabled[STUB_IRQn_MAX];
+uint8_t  stub_irq_pending[STUB_IRQn_MAX];
+
+void NVIC_EnableIRQ (IRQn_Type irq)
+{
+	stub_irq_enabled[irq] = 1;
+}
+
+void NVIC_ClearPendingIRQ (IRQn_Type irq)
+{
+	stub_irq_pending[irq] = 0;
+}
+
+uint32_t __get_PRIMASK (void)
+{
+	return stub_primask;
+}
+
+void __set_PRIMASK (uint32_t primask)
+{
+	stub_primask = primask;
+}
+
+void __disable_irq (void)
+{
+	stub_primask = 1;
+}
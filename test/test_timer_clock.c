@@ -0,0 +1,147 @@
+/*
+ * test_timer_clock.c
+ *
+ *  Checks the time to tick conversion at fCCU of 24, 48, 80 and 120 MHz
+ *  against the exact rounded value, that the static default factors match
+ *  the factors computed at run time, and that armed timeouts are re-planned
+ *  when fCCU changes, also when their remaining time rounds to zero ticks,
+ *  and that lateness thresholds saturate at the 32 bit tick range.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <xmc4500_timer_driver.h>
+#include <xmc4500_timer_lib.h>
+#include "test_check.h"
+
+static const uint32_t clocks[] = { 24000000UL, 48000000UL, 80000000UL, 120000000UL,
+                                   /* Odd values to exercise the fraction */
+                                   47923000UL, 119999999UL };
+
+static void callback (void)
+{
+}
+
+static uint32_t next (void)
+{
+	return ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+}
+
+/*
+ * The conversion truncates the fixed-point product, so it is at most one tick
+ * off the exact value rounded to nearest.
+ */
+static void check_conversion (uint32_t hz)
+{
+	uint64_t exact, ticks, diff, worst_us = 0, worst_ms = 0;
+	uint32_t x;
+	uint32_t i;
+
+	CHECK(update_timer_clock (hz));
+	for (i = 0; i < 200000; i++) {
+		x = (i < 1000) ? i : (i < 1010) ? 0xFFFFFFFFUL - (i - 1000) : next();
+		exact = ((uint64_t) x * hz + 500000UL) / 1000000UL;
+		ticks = timer_us_to_ticks (x);
+		diff = ticks > exact ? ticks - exact : exact - ticks;
+		worst_us = diff > worst_us ? diff : worst_us;
+		exact = ((uint64_t) x * hz + 500UL) / 1000UL;
+		ticks = timer_ms_to_ticks (x);
+		diff = ticks > exact ? ticks - exact : exact - ticks;
+		worst_ms = diff > worst_ms ? diff : worst_ms;
+	}
+	printf("fCCU %9lu Hz: us %lu + %lu/2^32, ms %lu + %lu/2^32, "
+	       "worst error us %llu ms %llu ticks\n", (unsigned long) hz,
+	       (unsigned long) timer_scale_us.whole, (unsigned long) timer_scale_us.frac,
+	       (unsigned long) timer_scale_ms.whole, (unsigned long) timer_scale_ms.frac,
+	       (unsigned long long) worst_us, (unsigned long long) worst_ms);
+	CHECK(worst_us <= 1);
+	CHECK(worst_ms <= 1);
+}
+
+static void check_defaults (void)
+{
+	const timer_scale_t us = timer_scale_us;
+	const timer_scale_t ms = timer_scale_ms;
+	uint8_t i;
+
+	//The static defaults are the run-time factors of TIMER_CLOCK_HZ
+	CHECK(update_timer_clock (TIMER_CLOCK_HZ));
+	CHECK(us.whole == timer_scale_us.whole && us.frac == timer_scale_us.frac);
+	CHECK(ms.whole == timer_scale_ms.whole && ms.frac == timer_scale_ms.frac);
+	for (i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++) {
+		const timer_scale_t s_us = TIMER_SCALE(clocks[i], 1000000UL);
+		const timer_scale_t s_ms = TIMER_SCALE(clocks[i], 1000UL);
+
+		CHECK(update_timer_clock (clocks[i]));
+		CHECK(s_us.whole == timer_scale_us.whole && s_us.frac == timer_scale_us.frac);
+		CHECK(s_ms.whole == timer_scale_ms.whole && s_ms.frac == timer_scale_ms.frac);
+	}
+}
+
+static void check_rescale (void)
+{
+	CHECK(update_timer_clock (120000000UL));
+
+	//A one-shot timeout keeps its remaining time
+	CHECK(timeout_ms (100, callback) == 0);
+	test_running (&timer_timeout, true);
+	CHECK(update_timer_clock (24000000UL));
+	CHECK(timer_timeout.ticks == 2400000ULL);
+	CHECK(timer_timeout.periodic == false);
+	reset_timer_timeout();
+	test_running (&timer_timeout, false);
+
+	//A timeout which rounds to zero ticks is restarted with one tick
+	CHECK(update_timer_clock (120000000UL));
+	CHECK(timeout_ticks (2, callback) == 0);
+	test_running (&timer_timeout, true);
+	CHECK(update_timer_clock (24000000UL));
+	CHECK(timer_timeout.ticks == 1);
+	CHECK(timer_timeout.current == 0);
+	reset_timer_timeout();
+	test_running (&timer_timeout, false);
+
+	//A periodic timeout is restarted with its rescaled period
+	CHECK(update_timer_clock (120000000UL));
+	CHECK(timeout_periodic_ms (10, callback) == 0);
+	test_running (&timer_timeout, true);
+	CHECK(update_timer_clock (48000000UL));
+	CHECK(timer_timeout.ticks == 480000ULL);
+	CHECK(timer_timeout.periodic);
+	CHECK(update_timer_clock (80000000UL));
+	CHECK(timer_timeout.ticks == 800000ULL);
+	reset_timer_timeout();
+	test_running (&timer_timeout, false);
+
+	//A stopped timeout is left alone
+	CHECK(update_timer_clock (120000000UL));
+	CHECK(timer_timeout.ticks == 800000ULL);
+
+	//Thresholds beyond 32 bit ticks saturate instead of wrapping, 40 s at
+	//120 MHz would wrap to 4.209 s
+	timeout_deadline (40000000UL, TIMER_POLICY_CATCH_UP, NULL);
+	CHECK(timer_timeout.deadline.threshold == UINT32_MAX);
+	timeout_deadline (20000000UL, TIMER_POLICY_CATCH_UP, NULL);
+	CHECK(timer_timeout.deadline.threshold == 2400000000UL);
+	CHECK(update_timer_clock (24000000UL));
+	CHECK(timer_timeout.deadline.threshold == 480000000UL);
+	timeout_deadline (100000000UL, TIMER_POLICY_CATCH_UP, NULL);
+	CHECK(timer_timeout.deadline.threshold == 2400000000UL);
+	CHECK(update_timer_clock (120000000UL));
+	CHECK(timer_timeout.deadline.threshold == UINT32_MAX);
+	timeout_deadline (0, TIMER_POLICY_CATCH_UP, NULL);
+}
+
+int main (void)
+{
+	uint8_t i;
+
+	configure_timer();
+	configure_timer_timeout();
+	check_defaults();
+	for (i = 0; i < sizeof(clocks) / sizeof(clocks[0]); i++) {
+		check_conversion (clocks[i]);
+	}
+	check_rescale();
+	return test_result();
+}
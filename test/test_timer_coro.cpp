@@ -0,0 +1,115 @@
+/*
+ * test_timer_coro.cpp
+ *
+ *  Host build of the C++20 task coroutines. The task period interrupt is
+ *  called by hand. Checks that locals survive awaits, also within a switch
+ *  statement, that the static frame and task pools are released when a
+ *  coroutine returns, and that a frame which does not fit is refused.
+ */
+
+extern "C" {
+#include <xmc4500_timer_driver.h>
+#include <xmc4500_timer_lib.h>
+void CCU42_0_IRQHandler(void);
+}
+#include <xmc4500_timer_task.hpp>
+#include "test_check.h"
+
+static uint32_t trace[16];
+static uint8_t traced;
+
+static timer::task counter (uint8_t id, uint8_t rounds)
+{
+	uint32_t sum = 0;
+	uint8_t i;
+
+	for (i = 0; i < rounds; i++) {
+		switch (i % 3) {
+		case 0:
+			sum += co_await timer::periods (1) + 1;
+			break;
+		case 1:
+			co_await timer::yield (); co_await timer::yield ();
+			sum += 10;
+			break;
+		default:
+			sum += (co_await timer::delay (1) == 0) ? 100 : 0;
+			break;
+		}
+	}
+	trace[traced++] = id * 1000UL + sum;
+}
+
+static timer::task oversized (void)
+{
+	volatile uint8_t buffer[TIMER_FRAME_SIZE];
+
+	buffer[0] = 1;
+	co_await timer::yield ();
+	trace[traced++] = buffer[0];
+}
+
+static void run_periods (uint8_t periods)
+{
+	uint8_t i;
+
+	for (i = 0; i < periods; i++) {
+		task_run();
+		task_run();
+		task_run();
+		CCU42_0_IRQHandler();
+	}
+	task_run();
+}
+
+static void test_locals (void)
+{
+	//Two rounds of each case: 2 * (1 + 10 + 100)
+	traced = 0;
+	CHECK(timer::spawn (counter (1, 6)) != NULL);
+	CHECK(timer::spawn (counter (2, 3)) != NULL);
+	run_periods (10);
+	CHECK(traced == 2);
+	CHECK(trace[0] == 2111);
+	CHECK(trace[1] == 1222);
+}
+
+static void test_pools (void)
+{
+	uint8_t i;
+
+	//Every task of the pool gets a frame, one more does not
+	traced = 0;
+	for (i = 0; i < TIMER_TASKS_MAX; i++) {
+		CHECK(timer::spawn (counter (i, 1)) != NULL);
+	}
+	CHECK(timer::spawn (counter (9, 1)) == NULL);
+	run_periods (2);
+	CHECK(traced == TIMER_TASKS_MAX);
+	//Released again once the coroutines have returned
+	CHECK(timer::spawn (counter (9, 1)) != NULL);
+	run_periods (2);
+	CHECK(traced == TIMER_TASKS_MAX + 1);
+	CHECK(trace[TIMER_TASKS_MAX] == 9001);
+}
+
+static void test_oversized (void)
+{
+	//A frame above TIMER_FRAME_SIZE is refused, the pools stay usable
+	traced = 0;
+	CHECK(timer::spawn (oversized ()) == NULL);
+	CHECK(timer::spawn (counter (3, 1)) != NULL);
+	run_periods (2);
+	CHECK(traced == 1);
+	CHECK(trace[0] == 3001);
+}
+
+int main (void)
+{
+	configure_timer_timeout();
+	CHECK(setup_task (1000));
+	test_locals();
+	test_pools();
+	test_oversized();
+	return test_result();
+}
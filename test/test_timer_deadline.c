@@ -0,0 +1,269 @@
+/*
+ * test_timer_deadline.c
+ *
+ *  Simulates a periodic timeout on the host. The simulated clock drives the
+ *  CCU42 timestamp registers and raises the pending CCU41 interrupt on every
+ *  hardware period match. Interrupt entry is delayed to inject contention and
+ *  single callbacks are made slow, then the lateness, missed periods,
+ *  overruns and callback counts are checked for both policies, and a timeout
+ *  stopped from its own callback does not catch up missed periods. The
+ *  timestamp has to run only while a supervised timeout is armed.
+ */
+
+#include <stdio.h>
+#include <xmc4500_timer_driver.h>
+#include <xmc4500_timer_lib.h>
+#include "test_check.h"
+
+#define PERIOD          60000ULL        //0.5 ms at 120 MHz, one hardware period
+#define LATENCY         100ULL          //Interrupt entry latency
+#define CALLBACK        200ULL          //Duration of a normal callback
+
+void CCU41_0_IRQHandler(void);
+
+typedef struct {
+	const char *name;
+	uint8_t  policy;
+	uint32_t blocked_at;            //Match whose interrupt entry is delayed
+	uint64_t blocked;               //Delay in ticks
+	uint32_t slow_at;               //Callback which runs long
+	uint64_t slow;                  //Duration in ticks
+	uint32_t callbacks;             //Expected callbacks after 100 matches
+	uint32_t misses;
+	uint32_t overruns;
+	uint64_t late_max;
+} scenario_t;
+
+static uint64_t sim_now;
+static uint64_t sim_next;
+static uint32_t sim_matches;
+static uint32_t sim_callbacks;
+static const scenario_t *sim;
+
+static void sim_time (uint64_t t)
+{
+	while (sim_next <= t) {
+		sim_matches++;
+		sim_next += PERIOD;
+		stub_irq_pending[CCU41_0_IRQn] = 1;
+	}
+	sim_now = t;
+	CCU42_CC41->TIMER = t & 0xFFFF;
+	CCU42_CC42->TIMER = (t >> 16) & 0xFFFF;
+	CCU42_CC43->TIMER = (t >> 32) & 0xFFFF;
+}
+
+static void sim_callback (void)
+{
+	sim_callbacks++;
+	sim_time (sim_now + ((sim_callbacks == sim->slow_at) ? sim->slow : CALLBACK));
+}
+
+static void sim_interrupt (void)
+{
+	uint64_t entry = sim_now + LATENCY;
+
+	if (sim_matches == sim->blocked_at) {
+		entry += sim->blocked;
+	}
+	sim_time (entry);
+	stub_irq_pending[CCU41_0_IRQn] = 0;
+	CCU41_0_IRQHandler();
+}
+
+static void run (const scenario_t *scenario)
+{
+	const timer_deadline_t *deadline = &timer_timeout.deadline;
+
+	sim = scenario;
+	sim_callbacks = 0;
+	sim_matches = 0;
+	stub_irq_pending[CCU41_0_IRQn] = 0;
+	sim_next = UINT64_MAX;
+	sim_time (0x0000FFFFFFF00000ULL);       //Wraps during the run
+	CHECK(timeout_periodic_ticks (PERIOD, 0, sim_callback) == 0);
+	timeout_deadline (0, scenario->policy, NULL);
+	CHECK(timer_timeout.segments == 1);
+	CHECK(timer_timeout.segment[0].repeat == 1);
+	CHECK(timer_timeout.error == 0);
+	sim_next = sim_now + PERIOD;
+
+	while (sim_matches < 100) {
+		if (stub_irq_pending[CCU41_0_IRQn] == 0) {
+			sim_time (sim_next);
+		}
+		sim_interrupt();
+	}
+	while (stub_irq_pending[CCU41_0_IRQn]) {
+		sim_interrupt();
+	}
+	printf("%-22s matches %3u callbacks %3u fires %3u misses %u overruns %u "
+	       "late max %6u\n", scenario->name, sim_matches, sim_callbacks,
+	       deadline->fires, deadline->misses, deadline->overruns,
+	       deadline->late_max);
+	CHECK(sim_callbacks == scenario->callbacks);
+	CHECK(deadline->fires == sim_callbacks);
+	CHECK(deadline->misses == scenario->misses);
+	CHECK(deadline->overruns == scenario->overruns);
+	CHECK(deadline->late_max == scenario->late_max);
+	reset_timer_timeout();
+}
+
+static const scenario_t scenarios[] = {
+	{ "undisturbed",          TIMER_POLICY_CATCH_UP,  0, 0,  0, 0,
+	  100, 0, 0, LATENCY },
+	/* Entry blocked for 2.5 periods: lateness in full, two missed periods */
+	{ "blocked, catch up",    TIMER_POLICY_CATCH_UP, 10, PERIOD * 5 / 2,  0, 0,
+	  100, 2, 0, LATENCY + PERIOD * 5 / 2 },
+	{ "blocked, skip",        TIMER_POLICY_SKIP,     10, PERIOD * 5 / 2,  0, 0,
+	  98, 2, 0, LATENCY + PERIOD * 5 / 2 },
+	/* One callback runs 2.3 periods */
+	{ "slow, catch up",       TIMER_POLICY_CATCH_UP,  0, 0, 20, PERIOD * 23 / 10,
+	  100, 1, 1, 2 * LATENCY + PERIOD * 13 / 10 },
+	{ "slow, skip",           TIMER_POLICY_SKIP,      0, 0, 20, PERIOD * 23 / 10,
+	  98, 2, 1, LATENCY },
+};
+
+//Single expirations raised by hand
+static const scenario_t single = { "single", 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+static uint32_t late_reported;
+
+static void late_callback (uint32_t late)
+{
+	late_reported = late;
+}
+
+static void test_one_shot (void)
+{
+	//A one-shot timeout reports its lateness above the threshold
+	sim = &single;
+	sim_callbacks = 0;
+	sim_matches = 0;
+	sim_next = UINT64_MAX;
+	sim_time (1000);
+	CHECK(timeout_ticks (PERIOD, sim_callback) == 0);
+	timeout_deadline (1, TIMER_POLICY_CATCH_UP, late_callback);
+	sim_next = sim_now + PERIOD;
+	sim_time (sim_next + 777);
+	stub_irq_pending[CCU41_0_IRQn] = 0;
+	CCU41_0_IRQHandler();
+	CHECK(sim_callbacks == 1);
+	CHECK(timer_timeout.deadline.late_last == 777);
+	CHECK(timer_timeout.deadline.misses == 1);
+	CHECK(late_reported == 777);
+	reset_timer_timeout();
+}
+
+static void test_timestamp (void)
+{
+	CCU42_CC43->TIMER = 0x1234;
+	CCU42_CC42->TIMER = 0x5678;
+	CCU42_CC41->TIMER = 0x9ABC;
+	CHECK(timer_timestamp() == 0x123456789ABCULL);
+}
+
+static void test_timestamp_gate (void)
+{
+	const uint32_t idle = (0x01UL << CCU4_GIDLS_SS1I_Pos) | 
+	                      (0x01UL << CCU4_GIDLS_SS2I_Pos) | 
+	                      (0x01UL << CCU4_GIDLS_SS3I_Pos);
+
+	//Without supervision the timestamp is not started
+	sim = &single;
+	timeout_deadline (0, TIMER_POLICY_OFF, NULL);
+	CCU42_CC41->TCSET = 0;
+	CCU42_CC41->TCCLR = 0;
+	CHECK(timeout_periodic_ticks (PERIOD, 0, sim_callback) == 0);
+	CHECK(CCU42_CC41->TCSET == 0);
+	//Started with the supervision of the running timeout, stopped with it
+	timeout_deadline (0, TIMER_POLICY_SKIP, NULL);
+	CHECK(CCU42_CC41->TCSET == (0x01UL << CCU4_CC4_TCSET_TRBS_Pos));
+	CHECK(CCU42_CC41->TCCLR == 0);
+	CCU42->GIDLS = 0;
+	reset_timer_timeout();
+	CHECK(CCU42_CC41->TCCLR == (0x01UL << CCU4_CC4_TCCLR_TRBC_Pos));
+	CHECK((CCU42->GIDLS & idle) == idle);
+	//A supervised one-shot timeout holds it until it expires
+	CCU42_CC41->TCSET = 0;
+	CCU42_CC41->TCCLR = 0;
+	CHECK(timeout_ticks (PERIOD, sim_callback) == 0);
+	CHECK(CCU42_CC41->TCSET == (0x01UL << CCU4_CC4_TCSET_TRBS_Pos));
+	CHECK(CCU42_CC41->TCCLR == 0);
+	CCU41_0_IRQHandler();
+	CHECK(CCU42_CC41->TCCLR == (0x01UL << CCU4_CC4_TCCLR_TRBC_Pos));
+	//Ending the supervision of a running timeout releases it as well
+	CCU42_CC41->TCCLR = 0;
+	CHECK(timeout_periodic_ticks (PERIOD, 0, sim_callback) == 0);
+	timeout_deadline (0, TIMER_POLICY_OFF, NULL);
+	CHECK(CCU42_CC41->TCCLR == (0x01UL << CCU4_CC4_TCCLR_TRBC_Pos));
+	reset_timer_timeout();
+	function_adress = NULL;
+}
+
+static void test_failed_periodic (void)
+{
+	//A rejected periodic timeout keeps the callback of the running one
+	function_adress = sim_callback;
+	CHECK(timeout_periodic_ticks (0, 0, NULL) == 1);
+	CHECK(function_adress == sim_callback);
+	function_adress = NULL;
+}
+
+static void stop_callback (void)
+{
+	sim_callbacks++;
+	reset_timer_timeout();
+}
+
+static void test_stop_in_callback (void)
+{
+	//Entered 3.5 periods late with catch up: the callback stops the timeout,
+	//the two missed periods are not called back any more
+	sim = &single;
+	sim_callbacks = 0;
+	sim_matches = 0;
+	sim_next = UINT64_MAX;
+	sim_time (5000);
+	CHECK(timeout_periodic_ticks (PERIOD, 0, stop_callback) == 0);
+	timeout_deadline (0, TIMER_POLICY_CATCH_UP, NULL);
+	sim_time (sim_now + PERIOD * 7 / 2);
+	stub_irq_pending[CCU41_0_IRQn] = 0;
+	CCU41_0_IRQHandler();
+	CHECK(sim_callbacks == 1);
+	CHECK(timer_timeout.deadline.pending == 0);
+	CHECK(timer_timeout.periodic == false);
+	CHECK(timer_timeout.deadline.misses == 2);
+	function_adress = NULL;
+}
+
+static void test_callback_first (void)
+{
+	//A one tick timeout replaces the callback before it can expire, and a
+	//match left pending by the previous timeout is dropped
+	function_adress = sim_callback;
+	stub_irq_pending[CCU41_0_IRQn] = 1;
+	CHECK(timeout_ticks (1, test_callback_first) == 0);
+	CHECK(function_adress == test_callback_first);
+	CHECK(stub_irq_pending[CCU41_0_IRQn] == 0);
+	CHECK(__get_PRIMASK() == 0);
+	reset_timer_timeout();
+	function_adress = NULL;
+}
+
+int main (void)
+{
+	uint8_t i;
+
+	configure_timer_timeout();
+	test_timestamp();
+	test_timestamp_gate();
+	for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+		run (&scenarios[i]);
+	}
+	test_one_shot();
+	test_failed_periodic();
+	test_stop_in_callback();
+	test_callback_first();
+	return test_result();
+}
@@ -0,0 +1,305 @@
+/*
+ * test_timer_group.c
+ *
+ *  Checks the register setup of a synchronised group and the groups which
+ *  are rejected. Reports the start skew of the groups by replaying the global
+ *  start on the programmed registers, with a free-running prescaler of
+ *  random phase per module; rejected groups are programmed module by module
+ *  to show the skew they would have. Checks timer_group_peak() against a
+ *  tick by tick simulation of the outputs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <xmc4500_timer_driver.h>
+#include "test_check.h"
+
+//Slices not used by the delay, timeout, task timer and timestamp
+static const uint8_t free_slices[][2] = {
+	{ 0, 3 }, { 1, 3 }, { 3, 0 }, { 3, 1 }, { 3, 2 }, { 3, 3 }
+};
+#define FREE_SLICES     (sizeof(free_slices) / sizeof(free_slices[0]))
+
+static void random_group (timer_group_t *group, uint8_t prescaler)
+{
+	uint8_t order[FREE_SLICES];
+	uint8_t i, j, tmp;
+
+	for (i = 0; i < FREE_SLICES; i++) {
+		order[i] = i;
+	}
+	for (i = FREE_SLICES - 1; i > 0; i--) {
+		j = rand() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	group->slices = 1 + rand() % FREE_SLICES;
+	group->prescaler = prescaler;
+	group->period = 1 + rand() % 2000;
+	for (i = 0; i < group->slices; i++) {
+		group->slice[i].module = free_slices[order[i]][0];
+		group->slice[i].slice = free_slices[order[i]][1];
+		group->slice[i].phase = rand() % (group->period + 1);
+		group->slice[i].compare = rand() % (group->period + 2);
+	}
+}
+
+static void test_registers (void)
+{
+	timer_group_t group = {
+		.slice = {
+			{ .module = 3, .slice = 0, .phase = 0,   .compare = 500 },
+			{ .module = 3, .slice = 1, .phase = 250, .compare = 500 },
+			{ .module = 3, .slice = 2, .phase = 500, .compare = 500 },
+			{ .module = 0, .slice = 3, .phase = 750, .compare = 500 },
+		},
+		.slices = 4,
+		.prescaler = 0,
+		.period = 999
+	};
+	uint16_t compare[4] = { 100, 200, 300, 400 };
+
+	CCU40->GCSS = 0;
+	CCU43->GCSS = 0;
+	CHECK(configure_timer_group (&group));
+	CHECK(CCU43_CC41->INS == ((0x08UL << CCU4_CC4_INS_EV0IS_Pos) |
+	                          (0x01UL << CCU4_CC4_INS_EV0EM_Pos)));
+	CHECK(CCU43_CC41->CMC == (0x01UL << CCU4_CC4_CMC_STRTS_Pos));
+	CHECK(CCU43_CC42->PSC == 0);
+	CHECK(CCU40_CC43->PRS == 999);
+	CHECK(CCU40_CC43->CRS == 500);
+	CHECK(CCU43_CC41->TIMER == 250);
+	CHECK(CCU40_CC43->TIMER == 750);
+	CHECK(CCU43->GCSS == ((0x01UL << CCU4_GCSS_S0SE_Pos) |
+	                      (0x01UL << CCU4_GCSS_S1SE_Pos) |
+	                      (0x01UL << CCU4_GCSS_S2SE_Pos)));
+	CHECK(CCU40->GCSS == (0x01UL << CCU4_GCSS_S3SE_Pos));
+
+	SCU_GENERAL->CCUCON = 0;
+	timer_group_start (&group);
+	CHECK(SCU_GENERAL->CCUCON == ((0x01UL << SCU_GENERAL_CCUCON_GSC40_Pos) |
+	                              (0x01UL << SCU_GENERAL_CCUCON_GSC43_Pos)));
+
+	CCU43->GCSS = 0;
+	CCU40->GCSS = 0;
+	timer_group_update (&group, compare);
+	CHECK(CCU43_CC42->CRS == 300);
+	CHECK(CCU40_CC43->CRS == 400);
+	CHECK(group.slice[0].compare == 100);
+	CHECK(CCU43->GCSS == ((0x01UL << CCU4_GCSS_S0SE_Pos) |
+	                      (0x01UL << CCU4_GCSS_S1SE_Pos) |
+	                      (0x01UL << CCU4_GCSS_S2SE_Pos)));
+	CHECK(CCU40->GCSS == (0x01UL << CCU4_GCSS_S3SE_Pos));
+
+	CCU43_CC42->TIMER = 12;
+	timer_group_stop (&group);
+	CHECK(CCU43_CC42->TIMER == 500);
+}
+
+static void test_reject (void)
+{
+	timer_group_t group = {
+		.slice = {
+			{ .module = 3, .slice = 0, .phase = 0, .compare = 10 },
+			{ .module = 3, .slice = 1, .phase = 5, .compare = 10 },
+		},
+		.slices = 2,
+		.prescaler = 0,
+		.period = 19
+	};
+
+	CHECK(configure_timer_group (&group));
+	//Duplicate slice
+	group.slice[1].slice = 0;
+	CHECK(configure_timer_group (&group) == false);
+	group.slice[1].slice = 1;
+	//Timer, task and timestamp slices
+	group.slice[1].module = 0;
+	group.slice[1].slice = 2;
+	CHECK(configure_timer_group (&group) == false);
+	group.slice[1].module = 2;
+	group.slice[1].slice = 3;
+	CHECK(configure_timer_group (&group) == false);
+	//Phase beyond the period
+	group.slice[1].module = 3;
+	group.slice[1].slice = 1;
+	group.slice[1].phase = 20;
+	CHECK(configure_timer_group (&group) == false);
+	group.slice[1].phase = 5;
+	//Prescaler within one module, but not across modules
+	group.prescaler = 3;
+	CHECK(configure_timer_group (&group));
+	group.slice[1].module = 1;
+	group.slice[1].slice = 3;
+	CHECK(configure_timer_group (&group) == false);
+	group.prescaler = 0;
+	CHECK(configure_timer_group (&group));
+	group.slices = 0;
+	CHECK(configure_timer_group (&group) == false);
+	group.slices = TIMER_GROUP_MAX + 1;
+	CHECK(configure_timer_group (&group) == false);
+}
+
+/*
+ * Replays the global start of a programmed group on the registers. Every
+ * module divides fCCU with its own free-running prescaler of random phase.
+ * A slice starts on the CCUCON edge of its module if it is set to start on a
+ * rising edge of the SCU global start, and counts up from its TIMER preload
+ * on every 2^PSC-th fCCU tick of its module prescaler. The start of a slice
+ * is the tick at which its counter held the phase offset it has in the group.
+ * Returns the spread of the starts in fCCU ticks, or UINT32_MAX if a slice
+ * does not start.
+ */
+static uint32_t start_skew (const timer_group_t *group)
+{
+	const uint32_t ccucon = SCU_GENERAL->CCUCON;
+	const CCU4_CC4_TypeDef *slice;
+	int64_t start, low = INT64_MAX, high = INT64_MIN;
+	uint32_t phase[4], divider, first;
+	uint8_t i, m;
+
+	for (i = 0; i < 4; i++) {
+		phase[i] = rand() % 0x8000;
+	}
+	for (i = 0; i < group->slices; i++) {
+		m = group->slice[i].module;
+		slice = &stub_cc4[m][group->slice[i].slice];
+		if ((((slice->INS >> CCU4_CC4_INS_EV0IS_Pos) & 0x0F) != 0x08) ||
+		    (((slice->INS >> CCU4_CC4_INS_EV0EM_Pos) & 0x03) != 0x01) ||
+		    (((slice->CMC >> CCU4_CC4_CMC_STRTS_Pos) & 0x03) != 0x01) ||
+		    !(ccucon & (0x01UL << (SCU_GENERAL_CCUCON_GSC40_Pos + m)))) {
+			return UINT32_MAX;
+		}
+		divider = 1UL << ((slice->PSC >> CCU4_CC4_PSC_PSIV_Pos) & 0x0F);
+		//First prescaler tick of the module after the start edge
+		first = divider - phase[m] % divider;
+		start = (int64_t) first - 
+		        ((int64_t) slice->TIMER + 1 - group->slice[i].phase) * divider;
+		low = start < low ? start : low;
+		high = start > high ? start : high;
+	}
+	return (uint32_t) (high - low);
+}
+
+/*
+ * Programs a rejected group module by module, each part on its own is a
+ * valid group, so its skew can be replayed.
+ */
+static _Bool configure_modules (const timer_group_t *group)
+{
+	timer_group_t part;
+	uint8_t i, m;
+
+	for (m = 0; m < 4; m++) {
+		part = *group;
+		part.slices = 0;
+		for (i = 0; i < group->slices; i++) {
+			if (group->slice[i].module == m) {
+				part.slice[part.slices++] = group->slice[i];
+			}
+		}
+		if (part.slices && (configure_timer_group (&part) == false)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void test_skew (void)
+{
+	timer_group_t group;
+	uint32_t accepted, rejected, skew, skew_accepted, skew_rejected;
+	_Bool valid;
+	uint8_t psc;
+	uint16_t n;
+
+	for (psc = 0; psc <= 6; psc++) {
+		accepted = rejected = skew_accepted = skew_rejected = 0;
+		for (n = 0; n < 2000; n++) {
+			random_group (&group, psc);
+			valid = configure_timer_group (&group);
+			if (valid == false) {
+				CHECK(configure_modules (&group));
+			}
+			SCU_GENERAL->CCUCON = 0;
+			timer_group_start (&group);
+			skew = start_skew (&group);
+			if (valid) {
+				accepted++;
+				skew_accepted = skew > skew_accepted ? skew : skew_accepted;
+			} else {
+				rejected++;
+				skew_rejected = skew > skew_rejected ? skew : skew_rejected;
+			}
+		}
+		printf("psc %u: %4u accepted, max skew %2u ticks; %4u rejected, "
+		       "max skew %2u ticks\n", psc, accepted, skew_accepted,
+		       rejected, skew_rejected);
+		CHECK(skew_accepted == 0);
+		CHECK(accepted > 0);
+		CHECK((psc > 0) || (rejected == 0));
+		//The rejected groups would start skewed, up to a prescaled tick
+		CHECK((psc == 0) || ((skew_rejected > 0) && (skew_rejected < (1UL << psc))));
+	}
+}
+
+static uint8_t simulated_peak (const timer_group_t *group)
+{
+	const uint32_t ticks = group->period + 1UL;
+	uint32_t t;
+	uint8_t i, active, peak = 0;
+
+	for (t = 0; t < ticks; t++) {
+		active = 0;
+		for (i = 0; i < group->slices; i++) {
+			if ((t + group->slice[i].phase) % ticks >= group->slice[i].compare) {
+				active++;
+			}
+		}
+		peak = active > peak ? active : peak;
+	}
+	return peak;
+}
+
+static void test_peak (void)
+{
+	timer_group_t group = {
+		.slice = {
+			{ .module = 3, .slice = 0, .compare = 750 },
+			{ .module = 3, .slice = 1, .compare = 750 },
+			{ .module = 3, .slice = 2, .compare = 750 },
+			{ .module = 3, .slice = 3, .compare = 750 },
+		},
+		.slices = 4,
+		.prescaler = 0,
+		.period = 999
+	};
+	uint8_t i, aligned;
+	uint16_t n;
+
+	//25 % duty: all four at once without phase, one at a time staggered
+	aligned = timer_group_peak (&group);
+	for (i = 0; i < 4; i++) {
+		group.slice[i].phase = i * 250;
+	}
+	printf("4 x 25 %% duty: peak %u aligned, %u staggered\n", aligned,
+	       timer_group_peak (&group));
+	CHECK(aligned == 4);
+	CHECK(timer_group_peak (&group) == 1);
+
+	for (n = 0; n < 2000; n++) {
+		random_group (&group, 0);
+		CHECK(timer_group_peak (&group) == simulated_peak (&group));
+	}
+}
+
+int main (void)
+{
+	srand(1);
+	test_registers();
+	test_reject();
+	test_skew();
+	test_peak();
+	return test_result();
+}
@@ -0,0 +1,74 @@
+/*
+ * test_timer_plan.c
+ *
+ *  Sweeps delay durations from one tick up to several days through the
+ *  segment planner and replays the period match interrupts, checking that the
+ *  programmed segments add up to the requested time.
+ */
+
+#include <stdio.h>
+#include <xmc4500_timer_driver.h>
+#include "test_check.h"
+
+/*
+ * Replays the interrupts of the running delay and returns the fCCU ticks the
+ * hardware counted until the request expired.
+ */
+static uint64_t replay (timer_channel_t *channel, uint32_t *interrupts)
+{
+	const timer_segment_t *segment;
+	uint64_t ticks = 0;
+
+	*interrupts = 0;
+	do {
+		segment = &channel->segment[channel->current];
+		ticks += ((uint64_t) (segment->period[0] + 1UL) *
+		          (segment->period[1] + 1UL) *
+		          (segment->period[2] + 1UL)) << segment->prescaler;
+		(*interrupts)++;
+	} while (timer_advance (channel) == true);
+	return ticks;
+}
+
+static void check (uint64_t ticks)
+{
+	uint32_t interrupts;
+	uint64_t counted;
+
+	if (_delay_ticks_configuration (ticks, 0) != 0) {
+		CHECK_MSG(false, "%llu: not accepted", (unsigned long long) ticks);
+		return;
+	}
+	counted = replay (&timer_delay, &interrupts);
+	CHECK_MSG((counted == ticks) && (timer_delay.error == 0) &&
+	          (interrupts <= TIMER_SEGMENTS_MAX + (ticks >> 48)),
+	          "%llu: counted %llu in %u interrupts", (unsigned long long) ticks,
+	          (unsigned long long) counted, interrupts);
+}
+
+int main (void)
+{
+	static const uint32_t ms[] = {
+		1, 99, 100, 999, 1000, 59999, 3600000, 3600001, 4 * 3600000,
+		86400000, 3 * 86400000UL, 7 * 86400000UL, 0xFFFFFFFFUL
+	};
+	uint64_t ticks, seed = 1;
+	uint32_t i;
+
+	CHECK(_delay_ticks_configuration (0, 0) != 0);
+	for (ticks = 1; ticks < 200000; ticks += 7) {
+		check (ticks);
+	}
+	for (i = 0; i < sizeof ms / sizeof ms[0]; i++) {
+		check (timer_ms_to_ticks (ms[i]));
+		printf("%10lu ms: %u segments, prescaler %u\n", (unsigned long) ms[i],
+		       timer_delay.segments, timer_delay.segment[0].prescaler);
+	}
+	//Random durations up to 7 days and beyond the 48 bit range
+	for (i = 0; i < 100000; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		check ((seed >> 20) % timer_ms_to_ticks (7 * 86400000UL) + 1);
+		check ((seed >> 4) + 1);
+	}
+	return test_result();
+}
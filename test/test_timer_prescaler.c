@@ -0,0 +1,150 @@
+/*
+ * test_timer_prescaler.c
+ *
+ *  Reports the configuration chosen for delays with a required resolution:
+ *  segments, slices, prescaler, timing error and a toggle-count power proxy,
+ *  compared with the former fixed fCCU/1 three slice setup. Checks that the
+ *  error stays within the resolution and that a coarse resolution never uses
+ *  more slices or a finer prescaler than an exact request. Reports the time of
+ *  a plan whose two slice search fails on every prescaler.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+#include <xmc4500_timer_driver.h>
+#include "test_check.h"
+
+/*
+ * Counter increments of all slices until the request expires. Every increment
+ * toggles two bits on average, so twice this is the toggle-count proxy.
+ */
+static uint64_t toggles (const timer_channel_t *channel)
+{
+	const timer_segment_t *segment;
+	uint64_t total = 0;
+	uint64_t units, scale;
+	uint8_t i, j;
+
+	for (i = 0; i < channel->segments; i++) {
+		segment = &channel->segment[i];
+		units = (uint64_t) (segment->period[0] + 1UL) *
+		        (segment->period[1] + 1UL) *
+		        (segment->period[2] + 1UL) * segment->repeat;
+		scale = 1;
+		for (j = 0; j < segment->slices; j++) {
+			total += units / scale;
+			scale *= segment->period[j] + 1UL;
+		}
+	}
+	return 2 * total;
+}
+
+static double seconds (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Time of one plan of a duration without a fitting pair of divisors, which
+ * exhausts the search budget before falling back to several segments.
+ */
+static void worst_case (void)
+{
+	const uint64_t ticks = 1046288599038ULL;
+	const uint64_t resolution = 1558;
+	double start;
+	uint32_t i;
+
+	start = seconds();
+	for (i = 0; i < 10000; i++) {
+		_delay_ticks_configuration (ticks, resolution);
+	}
+	printf("worst case plan %.2f us, %u segments, error %lld\n",
+	       (seconds() - start) * 1e6 / 10000, timer_delay.segments,
+	       (long long) timer_delay.error);
+	CHECK((timer_delay.error <= (int64_t) resolution) &&
+	      (timer_delay.error >= -(int64_t) resolution));
+}
+
+static void report (const char *name, uint64_t ticks, uint64_t resolution)
+{
+	const timer_segment_t *segment = &timer_delay.segment[0];
+	uint64_t actual = 0;
+	uint64_t error;
+	uint8_t i;
+
+	_delay_ticks_configuration (ticks, resolution);
+	for (i = 0; i < timer_delay.segments; i++) {
+		actual += ((uint64_t) (timer_delay.segment[i].period[0] + 1UL) *
+		           (timer_delay.segment[i].period[1] + 1UL) *
+		           (timer_delay.segment[i].period[2] + 1UL) *
+		           timer_delay.segment[i].repeat) << timer_delay.segment[i].prescaler;
+	}
+	error = actual > ticks ? actual - ticks : ticks - actual;
+	printf("%-12s res %10llu: %u seg, %u slices, psc %2u, error %8lld, "
+	       "toggles %14llu (fCCU/1: %14llu)\n", name,
+	       (unsigned long long) resolution, timer_delay.segments,
+	       segment->slices, segment->prescaler, (long long) timer_delay.error,
+	       (unsigned long long) toggles (&timer_delay),
+	       (unsigned long long) (2 * ticks));
+	CHECK_MSG((error <= resolution) && ((int64_t) (actual - ticks) == timer_delay.error),
+	          "error %llu", (unsigned long long) error);
+}
+
+int main (void)
+{
+	static const struct {
+		const char *name;
+		uint32_t ms;
+	} cases[] = {
+		{ "10 ms", 10 }, { "1 s", 1000 }, { "1 min", 60000 },
+		{ "1 h", 3600000 }, { "4 h", 4 * 3600000 }, { "1 day", 86400000 },
+		{ "3 days", 3 * 86400000UL }
+	};
+	static const uint32_t res_us[] = { 0, 1, 1000, 100000 };
+	uint64_t seed = 7;
+	uint32_t i, j;
+
+	for (i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+		for (j = 0; j < sizeof res_us / sizeof res_us[0]; j++) {
+			report (cases[i].name, timer_ms_to_ticks (cases[i].ms),
+			        timer_us_to_ticks (res_us[j]));
+		}
+	}
+	report ("1 us", timer_us_to_ticks (1), 0);
+	report ("1 h + 1", timer_ms_to_ticks (3600000) + 1, timer_us_to_ticks (1000));
+
+	//1 h within 1 ms is a single two slice segment at psc 13 or above
+	_delay_ticks_configuration (timer_ms_to_ticks (3600000), timer_us_to_ticks (1000));
+	CHECK((timer_delay.segments == 1) && (timer_delay.segment[0].slices <= 2) &&
+	      (timer_delay.segment[0].prescaler >= 13));
+	//1 h + 1 tick within 1 ms runs at the largest prescaler
+	_delay_ticks_configuration (timer_ms_to_ticks (3600000) + 1, timer_us_to_ticks (1000));
+	CHECK(timer_delay.segment[0].prescaler == TIMER_PRESCALER_MAX);
+	//Random durations: error within the resolution
+	for (i = 0; i < 20000; i++) {
+		uint64_t ticks, resolution, actual = 0;
+		uint8_t k;
+
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		ticks = (seed >> 24) + 1;
+		resolution = (seed >> 8) % 1000000;
+		_delay_ticks_configuration (ticks, resolution);
+		for (k = 0; k < timer_delay.segments; k++) {
+			actual += ((uint64_t) (timer_delay.segment[k].period[0] + 1UL) *
+			           (timer_delay.segment[k].period[1] + 1UL) *
+			           (timer_delay.segment[k].period[2] + 1UL) *
+			           timer_delay.segment[k].repeat) << timer_delay.segment[k].prescaler;
+		}
+		CHECK_MSG((actual > ticks ? actual - ticks : ticks - actual) <= resolution,
+		          "%llu / %llu", (unsigned long long) ticks,
+		          (unsigned long long) resolution);
+	}
+	worst_case();
+	return test_result();
+}
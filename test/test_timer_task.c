@@ -0,0 +1,310 @@
+/*
+ * test_timer_task.c
+ *
+ *  Host build of the cooperative tasks. The task period interrupt and the
+ *  timeout interrupt are called by hand. Checks the awaits without task
+ *  period, that task_run() returns while tasks yield in a loop, the PWM
+ *  period output, the refusal of a busy timeout and the release of a task
+ *  whose timeout was taken over by the application.
+ *  Reports the cost of resuming a task against the dispatch of a periodic
+ *  timeout callback, both through their interrupt handlers.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <time.h>
+#include <xmc4500_timer_driver.h>
+#include <xmc4500_timer_lib.h>
+#include <xmc4500_timer_task.h>
+#include "test_check.h"
+
+#define BENCH_EVENTS    1000000UL
+
+void CCU41_0_IRQHandler(void);
+void CCU42_0_IRQHandler(void);
+
+typedef struct {
+	uint32_t resumes;
+	uint8_t  result;
+	uint8_t  percent;
+	uint32_t ms;
+} context_t;
+
+static void period_task (timer_task_t *task)
+{
+	context_t *ctx = task->arg;
+
+	TASK_BEGIN(task);
+	TASK_AWAIT_PERIOD(task);
+	ctx->result = task->result;
+	ctx->resumes++;
+	TASK_AWAIT_DELAY(task, ctx->ms);
+	ctx->result = task->result;
+	ctx->resumes++;
+	TASK_END(task);
+}
+
+static void pwm_task (timer_task_t *task)
+{
+	context_t *ctx = task->arg;
+
+	TASK_BEGIN(task);
+	TASK_AWAIT_PWM_PERIOD(task, ctx->percent);
+	ctx->result = task->result;
+	ctx->resumes++;
+	TASK_END(task);
+}
+
+static void timeout_task (timer_task_t *task)
+{
+	context_t *ctx = task->arg;
+
+	TASK_BEGIN(task);
+	TASK_AWAIT_TIMEOUT(task, ctx->ms);
+	ctx->result = task->result;
+	ctx->resumes++;
+	TASK_END(task);
+}
+
+static void yield_task (timer_task_t *task)
+{
+	context_t *ctx = task->arg;
+
+	TASK_BEGIN(task);
+	while (ctx->resumes < ctx->ms) {
+		ctx->resumes++;
+		TASK_YIELD(task);
+	}
+	TASK_END(task);
+}
+
+static void bench_task (timer_task_t *task)
+{
+	context_t *ctx = task->arg;
+
+	TASK_BEGIN(task);
+	for (;;) {
+		TASK_AWAIT_PERIOD(task);
+		ctx->resumes++;
+	}
+	TASK_END(task);
+}
+
+static volatile uint32_t callbacks;
+
+static void bench_callback (void)
+{
+	callbacks++;
+}
+
+static void app_callback (void)
+{
+}
+
+static double seconds (void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void test_no_period (void)
+{
+	context_t ctx = { 0, 0, 0, 5 };
+
+	//Without setup_task() both awaits return at once with result 1, the task
+	//is resumed by the next task_run()
+	CHECK(task_create (period_task, &ctx) != NULL);
+	task_run();
+	CHECK(ctx.resumes == 0);
+	task_run();
+	CHECK(ctx.resumes == 1);
+	task_run();
+	CHECK(ctx.resumes == 2);
+	CHECK(ctx.result == 1);
+}
+
+static void test_yield (void)
+{
+	context_t ctx[2] = { { 0, 0, 0, 3 }, { 0, 0, 0, 3 } };
+	uint8_t i;
+
+	//Every task_run() resumes each yielding task once and returns
+	CHECK(task_create (yield_task, &ctx[0]) != NULL);
+	CHECK(task_create (yield_task, &ctx[1]) != NULL);
+	for (i = 1; i <= 3; i++) {
+		task_run();
+		CHECK(ctx[0].resumes == i);
+		CHECK(ctx[1].resumes == i);
+	}
+	//The fourth run leaves the loop and ends both tasks
+	task_run();
+	task_run();
+	CHECK(ctx[0].resumes == 3);
+	CHECK(ctx[1].resumes == 3);
+}
+
+static void test_period (void)
+{
+	context_t ctx = { 0, 0, 0, 3 };
+	uint8_t i;
+
+	CHECK(setup_task (1000));
+	//1 ms at 120 MHz: psc 1, 60000 counts, output inactive
+	CHECK(CCU42_CC40->PSC == 1);
+	CHECK(CCU42_CC40->PRS == 59999);
+	CHECK(CCU42_CC40->CRS == 60000);
+	CHECK(task_create (period_task, &ctx) != NULL);
+	task_run();
+	CHECK(ctx.resumes == 0);
+	CCU42_0_IRQHandler();
+	task_run();
+	CHECK(ctx.resumes == 1);
+	CHECK(ctx.result == 0);
+	for (i = 0; i < 3; i++) {
+		CHECK(ctx.resumes == 1);
+		CCU42_0_IRQHandler();
+		task_run();
+	}
+	CHECK(ctx.resumes == 2);
+	CHECK(ctx.result == 0);
+}
+
+static void test_pwm (void)
+{
+	context_t ctx = { 0, 0, 25, 0 };
+
+	CCU42->GCSS = 0;
+	CHECK(task_create (pwm_task, &ctx) != NULL);
+	task_run();
+	CHECK(CCU42_CC40->CRS == 45000);
+	CHECK(CCU42->GCSS & (0x01UL << CCU4_GCSS_S0SE_Pos));
+	CHECK(ctx.resumes == 0);
+	CCU42_0_IRQHandler();
+	task_run();
+	CHECK(ctx.resumes == 1);
+	CHECK(ctx.result == 0);
+	//The duty cycle survives a change of fCCU
+	update_timer_clock (60000000UL);
+	CHECK(CCU42_CC40->PRS == 59999);
+	CHECK(CCU42_CC40->PSC == 0);
+	CHECK(CCU42_CC40->CRS == 45000);
+	update_timer_clock (TIMER_CLOCK_HZ);
+	ctx.percent = 100;
+	ctx.resumes = 0;
+	CHECK(task_create (pwm_task, &ctx) != NULL);
+	task_run();
+	CHECK(CCU42_CC40->CRS == 0);
+	CCU42_0_IRQHandler();
+	task_run();
+	CHECK(ctx.resumes == 1);
+}
+
+static void test_timeout (void)
+{
+	context_t ctx = { 0, 0, 0, 5 };
+	uint16_t i;
+
+	//Own timeout expires with result 0
+	test_running (&timer_timeout, false);
+	CHECK(task_create (timeout_task, &ctx) != NULL);
+	task_run();
+	CHECK(ctx.resumes == 0);
+	test_running (&timer_timeout, true);
+	for (i = 0; (i < 1000) && (ctx.resumes == 0); i++) {
+		CCU41_0_IRQHandler();
+		task_run();
+	}
+	CHECK(ctx.resumes == 1);
+	CHECK(ctx.result == 0);
+
+	//Busy with an application timeout: refused at once
+	CHECK(timeout_ms (10, app_callback) == 0);
+	test_running (&timer_timeout, true);
+	ctx.resumes = 0;
+	CHECK(task_create (timeout_task, &ctx) != NULL);
+	task_run();
+	task_run();
+	CHECK(ctx.resumes == 1);
+	CHECK(ctx.result == 1);
+	CHECK(function_adress == app_callback);
+	reset_timer_timeout();
+	test_running (&timer_timeout, false);
+
+	//Taken over while waiting: released on the next task period
+	ctx.resumes = 0;
+	CHECK(task_create (timeout_task, &ctx) != NULL);
+	task_run();
+	CHECK(ctx.resumes == 0);
+	CHECK(timeout_ms (10, app_callback) == 0);
+	CCU42_0_IRQHandler();
+	task_run();
+	CHECK(ctx.resumes == 1);
+	CHECK(ctx.result == 1);
+
+	//The timeout is free again once the application timeout is gone
+	reset_timer_timeout();
+	test_running (&timer_timeout, false);
+	ctx.resumes = 0;
+	CHECK(task_create (timeout_task, &ctx) != NULL);
+	task_run();
+	CHECK(ctx.resumes == 0);
+	CHECK(function_adress != app_callback);
+	test_running (&timer_timeout, true);
+	for (i = 0; (i < 1000) && (ctx.resumes == 0); i++) {
+		CCU41_0_IRQHandler();
+		task_run();
+	}
+	CHECK(ctx.resumes == 1);
+	CHECK(ctx.result == 0);
+	test_running (&timer_timeout, false);
+}
+
+static void bench (void)
+{
+	context_t ctx = { 0, 0, 0, 0 };
+	double start, callback_ns, task_ns;
+	uint32_t i;
+
+	//Periodic timeout callback, dispatched by the CCU41 interrupt handler
+	CHECK(timeout_periodic_ticks (60000, 0, bench_callback) == 0);
+	test_running (&timer_timeout, true);
+	start = seconds();
+	for (i = 0; i < BENCH_EVENTS; i++) {
+		CCU41_0_IRQHandler();
+	}
+	callback_ns = (seconds() - start) * 1e9 / BENCH_EVENTS;
+	reset_timer_timeout();
+	test_running (&timer_timeout, false);
+
+	//Task resumed by the CCU42 task period interrupt handler
+
+	CHECK(task_create (bench_task, &ctx) != NULL);
+	task_run();
+	start = seconds();
+	for (i = 0; i < BENCH_EVENTS; i++) {
+		CCU42_0_IRQHandler();
+		task_run();
+	}
+	task_ns = (seconds() - start) * 1e9 / BENCH_EVENTS;
+
+	CHECK(callbacks == BENCH_EVENTS);
+	CHECK(ctx.resumes == BENCH_EVENTS);
+	printf("timeout callback %6.1f ns/event, task resume %6.1f ns/event "
+	       "(%u task slots scanned per period)\n",
+	       callback_ns, task_ns, TIMER_TASKS_MAX);
+}
+
+int main (void)
+{
+	configure_timer_timeout();
+	test_no_period();
+	test_yield();
+	test_period();
+	test_pwm();
+	test_timeout();
+	bench();
+	return test_result();
+}
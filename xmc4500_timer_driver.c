@@ -9,6 +9,37 @@
 
 #include <xmc4500_timer_driver.h>
 
+/******************************************************************** GLOBALS */
+timer_channel_t timer_delay = {
+	.module = CCU40,
+	.slice  = { CCU40_CC40, CCU40_CC41, CCU40_CC42 },
+	.irq    = CCU40_0_IRQn
+};
+timer_channel_t timer_timeout = {
+	.module = CCU41,
+	.slice  = { CCU41_CC40, CCU41_CC41, CCU41_CC42 },
+	.irq    = CCU41_0_IRQn
+};
+
+uint32_t      timer_clock_hz = TIMER_CLOCK_HZ;
+timer_scale_t timer_scale_us = TIMER_SCALE(TIMER_CLOCK_HZ, 1000000UL);
+timer_scale_t timer_scale_ms = TIMER_SCALE(TIMER_CLOCK_HZ, 1000UL);
+
+static uint64_t timer_task_ticks = 0;
+static uint8_t timer_task_percent = 0;
+
+static CCU4_GLOBAL_TypeDef * const timer_module[4] = { CCU40, CCU41, CCU42, CCU43 };
+static CCU4_CC4_TypeDef * const timer_slice[4][4] = {
+	{ CCU40_CC40, CCU40_CC41, CCU40_CC42, CCU40_CC43 },
+	{ CCU41_CC40, CCU41_CC41, CCU41_CC42, CCU41_CC43 },
+	{ CCU42_CC40, CCU42_CC41, CCU42_CC42, CCU42_CC43 },
+	{ CCU43_CC40, CCU43_CC41, CCU43_CC42, CCU43_CC43 }
+};
+static const uint32_t timer_slice_transfer[4] = {
+	0x01UL << CCU4_GCSS_S0SE_Pos, 0x01UL << CCU4_GCSS_S1SE_Pos,
+	0x01UL << CCU4_GCSS_S2SE_Pos, 0x01UL << CCU4_GCSS_S3SE_Pos
+};
+
 /*
  * \brief SCU_configuration() is a driver function to configure the SCU function 
  * registers for the CCU4 capture and compare unit.
@@ -25,12 +56,12 @@ void SCU_configuration (void)
 	SCU_RESET->PRSET0 |= 0x01UL << SCU_RESET_PRSET0_CCU40RS_Pos;
 	SCU_RESET->PRSET0 |= 0x01UL << SCU_RESET_PRSET0_CCU41RS_Pos;
 	SCU_RESET->PRSET0 |= 0x01UL << SCU_RESET_PRSET0_CCU42RS_Pos;
-	//SCU_RESET->PRSET1 |= 0x01UL << SCU_RESET_PRSET1_CCU43RS_Pos;
+	SCU_RESET->PRSET1 |= 0x01UL << SCU_RESET_PRSET1_CCU43RS_Pos;
 	//Releases reset of the CCU4
 	SCU_RESET->PRCLR0 |= 0x01UL << SCU_RESET_PRCLR0_CCU40RS_Pos;
 	SCU_RESET->PRCLR0 |= 0x01UL << SCU_RESET_PRCLR0_CCU41RS_Pos;
 	SCU_RESET->PRCLR0 |= 0x01UL << SCU_RESET_PRCLR0_CCU42RS_Pos;
-	//SCU_RESET->PRCLR1 |= 0x01UL << SCU_RESET_PRCLR1_CCU43RS_Pos;
+	SCU_RESET->PRCLR1 |= 0x01UL << SCU_RESET_PRCLR1_CCU43RS_Pos;
 	//Enables the CCU4 clock via the specific SCU register
 	SCU_CLK->CLKSET   |=  0x01UL << SCU_CLK_CLKSET_CCUCEN_Pos;
 	//CCU Clock Control in Sleep Mode (ENABLE)
@@ -38,6 +69,166 @@ void SCU_configuration (void)
 	return;
 }
 
+/*
+ * \brief timer_scale() computes the fixed-point conversion factor for a time 
+ * unit of 1/per_second seconds at the given fCCU.
+ *
+ * \param timer_scale_t *scale conversion factor to be computed
+ * \param uint32_t fccu_hz fCCU in Hz
+ * \param uint32_t per_second units per second
+ * \return none
+ */
+
+static void timer_scale (timer_scale_t *scale, uint32_t fccu_hz, 
+                         uint32_t per_second)
+{
+	const timer_scale_t rounded = TIMER_SCALE(fccu_hz, per_second);
+
+	*scale = rounded;
+	return;
+}
+
+/*
+ * \brief timer_rescale() converts a number of ticks from one fCCU to another 
+ * without overflowing the intermediate product.
+ *
+ * \param uint64_t ticks ticks at the old fCCU
+ * \param uint32_t from_hz old fCCU in Hz
+ * \param uint32_t to_hz new fCCU in Hz
+ * \return ticks at the new fCCU
+ */
+
+static uint64_t timer_rescale (uint64_t ticks, uint32_t from_hz, uint32_t to_hz)
+{
+	return (ticks / from_hz) * to_hz + 
+	       ((ticks % from_hz) * to_hz + from_hz / 2) / from_hz;
+}
+
+/*
+ * \brief timer_us_to_ticks() converts microseconds into fCCU ticks.
+ *
+ * \param uint32_t us time in microseconds
+ * \return time in fCCU ticks
+ */
+
+uint64_t timer_us_to_ticks (uint32_t us)
+{
+	return (uint64_t) us * timer_scale_us.whole + 
+	       (((uint64_t) us * timer_scale_us.frac) >> 32);
+}
+
+/*
+ * \brief timer_ms_to_ticks() converts milliseconds into fCCU ticks.
+ *
+ * \param uint32_t ms time in milliseconds
+ * \return time in fCCU ticks
+ */
+
+uint64_t timer_ms_to_ticks (uint32_t ms)
+{
+	return (uint64_t) ms * timer_scale_ms.whole + 
+	       (((uint64_t) ms * timer_scale_ms.frac) >> 32);
+}
+
+/*
+ * \brief timer_supervised() reports whether a timer needs the timestamp, i.e.
+ * it has a request armed and its deadline is supervised.
+ *
+ * \param const timer_channel_t *channel timer to be checked
+ * \return true if the timer needs the timestamp, or false if not.
+ */
+
+static _Bool timer_supervised (const timer_channel_t *channel)
+{
+	return (channel->deadline.policy != TIMER_POLICY_OFF) && 
+	       (channel->current < channel->segments);
+}
+
+/*
+ * \brief timer_timestamp_update() starts slices CC41..CC43 of the CCU42 unit 
+ * as concatenated, free-running 48 bit counter at fCCU while the delay or the
+ * timeout needs it as time reference of its deadline bookkeeping, and stops 
+ * them and puts them into idle mode once no timer does, so they are not 
+ * clocked without supervision. Called whenever a timer is armed, expires, is
+ * stopped or its supervision changes, also from the interrupt service 
+ * routines, so the decision is taken with interrupts disabled.
+ *
+ * \param none
+ * \return none
+ */
+
+static void timer_timestamp_update (void)
+{
+	static _Bool running = false;
+	uint32_t primask = __get_PRIMASK();
+	_Bool needed;
+
+	__disable_irq();
+	needed = timer_supervised (&timer_delay) || timer_supervised (&timer_timeout);
+	if (needed == running) {
+		__set_PRIMASK(primask);
+		return;
+	}
+	running = needed;
+	if (needed == false) {
+		CCU42_CC41->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
+		CCU42_CC42->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos;
+		CCU42_CC43->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos;
+		//CC41..CC43 IDLE mode set
+		CCU42->GIDLS |= (0x01UL << CCU4_GIDLS_SS1I_Pos) | 
+		                (0x01UL << CCU4_GIDLS_SS2I_Pos) | 
+		                (0x01UL << CCU4_GIDLS_SS3I_Pos);
+		__set_PRIMASK(primask);
+		return;
+	}
+	//****** 	Prescale run bit set - Enables the prescaler Block
+	CCU42->GIDLC |= 0x01UL << CCU4_GIDLC_SPRB_Pos;
+	//Timer Concatenation Enable of CC42 and CC43
+	CCU42_CC42->CMC |= 0x01UL << CCU4_CC4_CMC_TCE_Pos;
+	CCU42_CC43->CMC |= 0x01UL << CCU4_CC4_CMC_TCE_Pos;
+	//Prescaler and Timer Shadow Period Value, full range at fCCU
+	CCU42_CC41->PSC = 0x00UL << CCU4_CC4_PSC_PSIV_Pos;
+	CCU42_CC42->PSC = 0x00UL << CCU4_CC4_PSC_PSIV_Pos;
+	CCU42_CC43->PSC = 0x00UL << CCU4_CC4_PSC_PSIV_Pos;
+	CCU42_CC41->PRS = 0xFFFFUL;
+	CCU42_CC42->PRS = 0xFFFFUL;
+	CCU42_CC43->PRS = 0xFFFFUL;
+	//Slice 1..3 shadow and prescaler shadow transfer set enable
+	CCU42->GCSS |= (0x01UL << CCU4_GCSS_S1SE_Pos) | (0x01UL << CCU4_GCSS_S1PSE_Pos) | 
+	               (0x01UL << CCU4_GCSS_S2SE_Pos) | (0x01UL << CCU4_GCSS_S2PSE_Pos) | 
+	               (0x01UL << CCU4_GCSS_S3SE_Pos) | (0x01UL << CCU4_GCSS_S3PSE_Pos);
+	//CC41..CC43 IDLE mode clear and timer start
+	CCU42->GIDLC |= (0x01UL << CCU4_GIDLC_CS1I_Pos) | 
+	                (0x01UL << CCU4_GIDLC_CS2I_Pos) | 
+	                (0x01UL << CCU4_GIDLC_CS3I_Pos);
+	CCU42_CC43->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
+	CCU42_CC42->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
+	CCU42_CC41->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
+	__set_PRIMASK(primask);
+	return;
+}
+
+/*
+ * \brief timer_timestamp() reads the free-running 48 bit timestamp. The upper
+ * slices are read again until no carry happened during the read.
+ *
+ * \param none
+ * \return timestamp in fCCU ticks, wrapping at TIMER_STAMP_MASK
+ */
+
+uint64_t timer_timestamp (void)
+{
+	uint32_t high, mid, low;
+
+	do {
+		high = CCU42_CC43->TIMER & CCU4_CC4_TIMER_TVAL_Msk;
+		mid = CCU42_CC42->TIMER & CCU4_CC4_TIMER_TVAL_Msk;
+		low = CCU42_CC41->TIMER & CCU4_CC4_TIMER_TVAL_Msk;
+	} while ((high != (CCU42_CC43->TIMER & CCU4_CC4_TIMER_TVAL_Msk)) || 
+	         (mid != (CCU42_CC42->TIMER & CCU4_CC4_TIMER_TVAL_Msk)));
+	return ((uint64_t) high << 32) | ((uint64_t) mid << 16) | low;
+}
+
 /*
  * \brief configure_timer() is a driver function to configure the CCU4 capture 
  * and compare unit for timer mode.
@@ -213,6 +404,980 @@ _Bool configure_timer_timeout (void)
 	return true;
 }
 
+/*
+ * \brief timer_task_compare() returns the compare value of the task slice for
+ * a duty cycle. The output of an edge aligned slice is active from the 
+ * compare match to the period match.
+ *
+ * \param uint32_t units timer counts per period (PR + 1)
+ * \param uint8_t percent duty cycle in percent, limited to 100
+ * \return compare value
+ */
+
+static uint16_t timer_task_compare (uint32_t units, uint8_t percent)
+{
+	uint32_t compare;
+
+	if (percent > 100) {
+		percent = 100;
+	}
+	compare = units - (units * percent) / 100;
+	return (compare > 0xFFFF) ? 0xFFFF : compare;
+}
+
+/*
+ * \brief configure_timer_task() is a driver function to configure slice CC40
+ * of the CCU42 unit as periodic timer for the cooperative tasks. A period 
+ * match interrupt is raised on node 0 every period.
+ *
+ * \param uint64_t ticks period in fCCU ticks
+ * \return true after successful configuration, or false if the period is out
+ * of range.
+ */
+
+_Bool configure_timer_task (uint64_t ticks)
+{
+	uint8_t psc = 0;
+
+	while ((psc <= TIMER_PRESCALER_MAX) && ((ticks >> psc) > 0x10000)) {
+		psc++;
+	}
+	if ((ticks == 0) || (psc > TIMER_PRESCALER_MAX)) {
+		return false;
+	}
+	timer_task_ticks = ticks;
+	//****** 	Prescale run bit set - Enables the prescaler Block
+	CCU42->GIDLC |= 0x01UL << CCU4_GIDLC_SPRB_Pos;
+	//Shadow Transfer on Clear
+	CCU42_CC40->TC |= 0x01UL << CCU4_CC4_TC_CLST_Pos;
+	//Prescaler and Timer Shadow Period Value
+	CCU42_CC40->PSC = psc << CCU4_CC4_PSC_PSIV_Pos;
+	CCU42_CC40->PRS = (ticks >> psc) - 1;
+	//Compare Shadow Value of the PWM output, kept across reconfiguration
+	CCU42_CC40->CRS = timer_task_compare (ticks >> psc, timer_task_percent);
+	//Slice 0 shadow transfer set enable
+	CCU42->GCSS |= 0x01UL << CCU4_GCSS_S0SE_Pos;
+	CCU42->GCSS |= 0x01UL << CCU4_GCSS_S0PSE_Pos;
+	/*******	INTERRUPT	*******/
+	//Period match while counting up enable
+	CCU42_CC40->INTE |= 0x01UL << CCU4_CC4_INTE_PME_Pos;
+	NVIC_EnableIRQ (CCU42_0_IRQn);
+	//CC40 IDLE mode clear and timer start
+	CCU42->GIDLC |= 0x01UL << CCU4_GIDLC_CS0I_Pos;
+	CCU42_CC40->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
+	return true;
+}
+
+/*
+ * \brief timer_task_duty() sets the duty cycle of the CCU42 CC40 output, so
+ * the task period doubles as PWM period. The new compare value is loaded by
+ * the shadow transfer at the end of the running period, i.e. it is active 
+ * from the next task period on. Routing CCU42.OUT0 to a pin is left to the
+ * application.
+ *
+ * \param uint8_t percent duty cycle in percent, limited to 100
+ * \return none
+ */
+
+void timer_task_duty (uint8_t percent)
+{
+	timer_task_percent = (percent > 100) ? 100 : percent;
+	CCU42_CC40->CRS = timer_task_compare (CCU42_CC40->PRS + 1UL, timer_task_percent);
+	//Slice 0 shadow transfer set enable
+	CCU42->GCSS |= 0x01UL << CCU4_GCSS_S0SE_Pos;
+	return;
+}
+
+/*
+ * \brief timer_group_modules() returns the CCUCON global start bits of the
+ * modules used by a group.
+ *
+ * \param const timer_group_t *group group of slices
+ * \return mask of GSC40..GSC43
+ */
+
+static uint32_t timer_group_modules (const timer_group_t *group)
+{
+	uint32_t mask = 0;
+	uint8_t i;
+
+	for (i = 0; i < group->slices; i++) {
+		mask |= 0x01UL << (SCU_GENERAL_CCUCON_GSC40_Pos + group->slice[i].module);
+	}
+	return mask;
+}
+
+/*
+ * \brief configure_timer_group() is a driver function to preload a group of
+ * slices across CCU40..CCU43 for a synchronised start. Every slice gets the 
+ * shared prescaler and period, its compare value and its phase offset as 
+ * counter start value, and is set to start on the rising edge of the SCU 
+ * global start signal (input INyI). The slices used by the delay, timeout and
+ * task timers and the timestamp (CC40..CC42 of CCU40 and CCU41, all of CCU42)
+ * and duplicate slices are rejected. Every module has its own prescaler which
+ * keeps running across the global start, so the prescaled ticks of two 
+ * modules are up to 2^prescaler - 1 fCCU ticks apart; a group spanning 
+ * several modules is therefore only accepted with prescaler 0, where all 
+ * counters start on the same fCCU clock edge.
+ * Routing the slice outputs to the port pins is left to the application.
+ *
+ * \param const timer_group_t *group group of slices
+ * \return true after successful configuration, or false if the group is 
+ * invalid.
+ */
+
+_Bool configure_timer_group (const timer_group_t *group)
+{
+	const timer_group_slice_t *member;
+	CCU4_CC4_TypeDef *slice;
+	uint32_t mask;
+	uint8_t i, j;
+
+	if ((group->slices == 0) || (group->slices > TIMER_GROUP_MAX) || 
+	    (group->prescaler > TIMER_PRESCALER_MAX)) {
+		return false;
+	}
+	for (i = 0; i < group->slices; i++) {
+		member = &group->slice[i];
+		if ((member->module > 3) || (member->slice > 3) || 
+		    (member->phase > group->period) || 
+		    ((member->module < 2) && (member->slice < TIMER_SLICES)) || 
+		    (member->module == 2)) {
+			return false;
+		}
+		for (j = 0; j < i; j++) {
+			if ((group->slice[j].module == member->module) && 
+			    (group->slice[j].slice == member->slice)) {
+				return false;
+			}
+		}
+	}
+	//Prescaler phases of different modules are not aligned
+	mask = timer_group_modules (group);
+	if (group->prescaler && (mask & (mask - 1))) {
+		return false;
+	}
+	timer_group_stop (group);
+	for (i = 0; i < group->slices; i++) {
+		member = &group->slice[i];
+		slice = timer_slice[member->module][member->slice];
+		//Prescale run bit set and IDLE mode clear
+		timer_module[member->module]->GIDLC |= 0x01UL << CCU4_GIDLC_SPRB_Pos;
+		timer_module[member->module]->GIDLC |= 
+			0x01UL << (CCU4_GIDLC_CS0I_Pos + member->slice);
+		//Event 0 on rising edge of INyI (SCU global start) starts the timer
+		slice->INS = (0x08UL << CCU4_CC4_INS_EV0IS_Pos) | 
+		             (0x01UL << CCU4_CC4_INS_EV0EM_Pos);
+		slice->CMC = 0x01UL << CCU4_CC4_CMC_STRTS_Pos;
+		//Prescaler, Period and Compare Shadow Register, phase as start value
+		slice->PSC = group->prescaler << CCU4_CC4_PSC_PSIV_Pos;
+		slice->PRS = group->period;
+		slice->CRS = member->compare;
+		slice->TIMER = member->phase;
+		timer_module[member->module]->GCSS |= timer_slice_transfer[member->slice];
+	}
+	return true;
+}
+
+/*
+ * \brief timer_group_start() starts all slices of a group at the same fCCU
+ * clock edge. The global start bits of the used modules are cleared and then
+ * set with a single CCUCON write.
+ *
+ * \param const timer_group_t *group group of slices
+ * \return none
+ */
+
+void timer_group_start (const timer_group_t *group)
+{
+	uint32_t mask = timer_group_modules (group);
+
+	SCU_GENERAL->CCUCON &= ~mask;
+	SCU_GENERAL->CCUCON |= mask;
+	return;
+}
+
+/*
+ * \brief timer_group_stop() stops all slices of a group and restores their 
+ * phase offsets, so the group can be started again.
+ *
+ * \param const timer_group_t *group group of slices
+ * \return none
+ */
+
+void timer_group_stop (const timer_group_t *group)
+{
+	CCU4_CC4_TypeDef *slice;
+	uint8_t i;
+
+	for (i = 0; i < group->slices; i++) {
+		slice = timer_slice[group->slice[i].module][group->slice[i].slice];
+		slice->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
+		slice->TIMER = group->slice[i].phase;
+	}
+	return;
+}
+
+/*
+ * \brief timer_group_update() updates the compare values of a group. All 
+ * compare shadow registers are written first and the shadow transfers of all 
+ * modules are requested afterwards with interrupts disabled. The CCU4 has no
+ * shadow transfer on a common event, so there is no shared boundary: every
+ * slice switches to its new value at the end of its own current period, i.e.
+ * within one period after the update. Slices with different phase offsets 
+ * switch at different times, so one period of the group may mix old and new
+ * values. A transfer request which lands just before a period end takes 
+ * effect there, otherwise one period later.
+ *
+ * \param timer_group_t *group group of slices
+ * \param const uint16_t *compare new compare value for every slice
+ * \return none
+ */
+
+void timer_group_update (timer_group_t *group, const uint16_t *compare)
+{
+	uint32_t transfer[4] = { 0, 0, 0, 0 };
+	uint32_t primask = __get_PRIMASK();
+	timer_group_slice_t *member;
+	uint8_t i;
+
+	for (i = 0; i < group->slices; i++) {
+		member = &group->slice[i];
+		member->compare = compare[i];
+		timer_slice[member->module][member->slice]->CRS = compare[i];
+		transfer[member->module] |= timer_slice_transfer[member->slice];
+	}
+	__disable_irq();
+	for (i = 0; i < 4; i++) {
+		if (transfer[i]) {
+			timer_module[i]->GCSS = transfer[i];
+		}
+	}
+	__set_PRIMASK(primask);
+	return;
+}
+
+/*
+ * \brief timer_group_peak() returns the largest number of outputs of a group
+ * which are active at the same time, to check the phase offsets against the 
+ * inrush current. The count is taken at every rising edge of the group.
+ *
+ * \param const timer_group_t *group group of slices
+ * \return peak number of simultaneously active outputs
+ */
+
+uint8_t timer_group_peak (const timer_group_t *group)
+{
+	const uint32_t ticks = group->period + 1UL;
+	const timer_group_slice_t *member;
+	uint32_t t, local;
+	uint8_t i, j, active;
+	uint8_t peak = 0;
+
+	for (j = 0; j <= group->slices; j++) {
+		//Rising edge of slice j in group time, t = 0 for the last pass
+		t = 0;
+		if (j < group->slices) {
+			member = &group->slice[j];
+			t = (member->compare + ticks - member->phase) % ticks;
+		}
+		active = 0;
+		for (i = 0; i < group->slices; i++) {
+			member = &group->slice[i];
+			local = (t + member->phase) % ticks;
+			if (local >= member->compare) {
+				active++;
+			}
+		}
+		if (active > peak) {
+			peak = active;
+		}
+	}
+	return peak;
+}
+
+/*
+ * \brief timer_plan_set() stores a single segment plan in the timer.
+ *
+ * \param timer_channel_t *channel timer to plan the segment for
+ * \param const uint32_t *count periods of CC40..CC42, unused slices 1
+ * \param uint8_t slices concatenated slices in use
+ * \param uint8_t psc prescaler
+ * \param uint64_t ticks requested fCCU ticks
+ * \return none
+ */
+
+static void timer_plan_set (timer_channel_t *channel, const uint32_t *count, 
+                            uint8_t slices, uint8_t psc, uint64_t ticks)
+{
+	timer_segment_t *segment = channel->segment;
+	uint64_t actual = (uint64_t) count[0] * count[1] * count[2] << psc;
+	uint8_t i;
+
+	for (i = 0; i < TIMER_SLICES; i++) {
+		segment->period[i] = count[i] - 1;
+	}
+	segment->slices = slices;
+	segment->prescaler = psc;
+	segment->repeat = 1;
+	channel->segments = 1;
+	channel->error = (int64_t) (actual - ticks);
+	return;
+}
+
+/*
+ * \brief timer_plan_single() looks for a single segment configuration which
+ * meets the required resolution. Fewer concatenated slices are preferred over
+ * a coarser prescaler, and for each number of slices the largest prescaler is
+ * taken, so unused slices stay idle and the counters toggle as slowly as
+ * possible. One slice only needs shifts, so short delays are planned within a
+ * few cycles. Two slices search the divisors of the prescaled duration and 
+ * its neighbours within the resolution, limited to TIMER_SEARCH_MAX 
+ * candidates over all prescalers, as the planner also runs in interrupts and
+ * with interrupts disabled. Three slices count as few upper periods as 
+ * possible and round the lowest slice. Exact requests (resolution 0) only try
+ * one slice. If nothing is found timer_plan() falls back to several segments.
+ *
+ * \param timer_channel_t *channel timer to plan the segment for
+ * \param uint64_t ticks duration in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks
+ * \return true if a configuration was found, or false if not.
+ */
+
+static _Bool timer_plan_single (timer_channel_t *channel, uint64_t ticks, 
+                                uint64_t resolution)
+{
+	uint32_t count[TIMER_SLICES] = { 1, 1, 1 };
+	uint64_t units, scale, limit, actual, error;
+	uint32_t n, x, y;
+	uint16_t budget = TIMER_SEARCH_MAX;
+	uint8_t psc, i;
+
+	//One slice
+	for (psc = TIMER_PRESCALER_MAX + 1; psc-- > 0; ) {
+		units = (ticks + ((1ULL << psc) >> 1)) >> psc;
+		units = units ? units : 1;
+		if (units > 0x10000) {
+			continue;
+		}
+		actual = units << psc;
+		if ((actual > ticks ? actual - ticks : ticks - actual) <= resolution) {
+			count[0] = (uint32_t) units;
+			timer_plan_set (channel, count, 1, psc, ticks);
+			return true;
+		}
+	}
+	if (resolution == 0) {
+		return false;
+	}
+	//Two slices, count[0] * count[1] close to the prescaled duration
+	for (psc = TIMER_PRESCALER_MAX + 1; psc-- > 0; ) {
+		units = (ticks + ((1ULL << psc) >> 1)) >> psc;
+		if (units > 0xFFFFFFFFUL) {
+			break;
+		}
+		if (units <= 0x10000) {
+			continue;
+		}
+		//y <= sqrt(n) <= x covers every pair with both counts <= 65536
+		n = (uint32_t) units;
+		y = (n >> 16) + ((n & 0xFFFF) != 0);
+		for (; (budget > 0) && ((uint64_t) y * y <= n); y++, budget--) {
+			x = (n + y / 2) / y;
+			if ((x == 0) || (x > 0x10000)) {
+				continue;
+			}
+			actual = (uint64_t) x * y << psc;
+			error = actual > ticks ? actual - ticks : ticks - actual;
+			if (error <= resolution) {
+				count[0] = x;
+				count[1] = y;
+				timer_plan_set (channel, count, 2, psc, ticks);
+				return true;
+			}
+		}
+	}
+	//Three slices
+	for (psc = TIMER_PRESCALER_MAX + 1; psc-- > 0; ) {
+		scale = 1ULL << psc;
+		for (i = TIMER_SLICES - 1; i > 0; i--) {
+			limit = scale << (16 * i);
+			units = ticks / limit + ((ticks % limit) != 0);
+			if (units > 0x10000) {
+				break;
+			}
+			count[i] = (uint32_t) units;
+			scale *= count[i];
+		}
+		if (i > 0) {
+			continue;
+		}
+		units = (ticks + scale / 2) / scale;
+		units = units ? units : 1;
+		actual = units * scale;
+		if ((units <= 0x10000) && 
+		    ((actual > ticks ? actual - ticks : ticks - actual) <= resolution)) {
+			count[0] = (uint32_t) units;
+			timer_plan_set (channel, count, 3, psc, ticks);
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * \brief timer_plan() splits a timer request into hardware segments. The
+ * period of CC40..CC42 is (PR0 + 1) * (PR1 + 1) * (PR2 + 1) prescaled ticks.
+ * If no single segment meets the resolution the request is prescaled by its 
+ * trailing zero bits, or by the largest power of two within the resolution 
+ * and rounded to it. It is then written in base 65536 and every non-zero digit
+ * becomes a segment using only as many slices as it needs. Full 48 bit 
+ * periods are repeated and counted in software.
+ *
+ * \param timer_channel_t *channel timer to plan the segments for
+ * \param uint64_t ticks duration in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks
+ * \return none
+ */
+
+static void timer_plan (timer_channel_t *channel, uint64_t ticks, 
+                        uint64_t resolution)
+{
+	timer_segment_t *segment = channel->segment;
+	uint64_t units;
+	uint32_t digit;
+	uint8_t level;
+	uint8_t psc = 0;
+
+	channel->current = 0;
+	if (timer_plan_single (channel, ticks, resolution) == true) {
+		return;
+	}
+	while ((psc < TIMER_PRESCALER_MAX) && 
+	       (!(ticks & (1ULL << psc)) || ((2ULL << psc) <= resolution))) {
+		psc++;
+	}
+	units = (ticks + ((1ULL << psc) >> 1)) >> psc;
+	units = units ? units : 1;
+	channel->segments = 0;
+	channel->error = (int64_t) ((units << psc) - ticks);
+	//Software extension beyond the 48 bit hardware range
+	digit = units >> 48;
+	if (digit) {
+		segment->period[0] = 0xFFFF;
+		segment->period[1] = 0xFFFF;
+		segment->period[2] = 0xFFFF;
+		segment->slices = TIMER_SLICES;
+		segment->prescaler = psc;
+		segment->repeat = digit;
+		segment++;
+		channel->segments++;
+	}
+	//Remaining digits, highest first
+	for (level = TIMER_SLICES; level > 0; level--) {
+		digit = (units >> (16 * (level - 1))) & 0xFFFF;
+		if (digit) {
+			segment->period[0] = (level > 1) ? 0xFFFF : digit - 1;
+			segment->period[1] = (level > 2) ? 0xFFFF :
+			                     (level == 2) ? digit - 1 : 0;
+			segment->period[2] = (level == 3) ? digit - 1 : 0;
+			segment->slices = level;
+			segment->prescaler = psc;
+			segment->repeat = 1;
+			segment++;
+			channel->segments++;
+		}
+	}
+	return;
+}
+
+/*
+ * \brief timer_halt() stops and clears all slices of a timer and puts them
+ * into idle mode, so they are not clocked until the next segment or request.
+ *
+ * \param timer_channel_t *channel timer to be halted
+ * \return none
+ */
+
+static void timer_halt (timer_channel_t *channel)
+{
+	uint8_t i;
+
+	for (i = 0; i < TIMER_SLICES; i++) {
+		channel->slice[i]->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
+		channel->slice[i]->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos;  //Timer clear
+		channel->module->GIDLS |= 0x01UL << (CCU4_GIDLS_SS0I_Pos + i); //IDLE mode set
+	}
+	return;
+}
+
+/*
+ * \brief timer_load() loads the current segment into the slices of the timer
+ * and starts it. Only the slices used by the segment are removed from idle 
+ * mode and the period match interrupt is taken from the top one.
+ *
+ * \param timer_channel_t *channel timer to be started
+ * \return none
+ */
+
+static void timer_load (timer_channel_t *channel)
+{
+	const timer_segment_t *segment = &channel->segment[channel->current];
+	uint8_t i;
+
+	//Prescale run bit set and IDLE mode clear of the used slices
+	channel->module->GIDLC |= 0x01UL << CCU4_GIDLC_SPRB_Pos;
+	for (i = 0; i < segment->slices; i++) {
+		channel->module->GIDLC |= 0x01UL << (CCU4_GIDLC_CS0I_Pos + i);
+	}
+	//Load Prescaler and Period Shadow Register
+	for (i = 0; i < TIMER_SLICES; i++) {
+		channel->slice[i]->PSC = segment->prescaler << CCU4_CC4_PSC_PSIV_Pos;
+		channel->slice[i]->PRS = segment->period[i];
+		//Period match interrupt of the top slice only
+		if (i == segment->slices - 1) {
+			channel->slice[i]->INTE |= 0x01UL << CCU4_CC4_INTE_PME_Pos;
+		} else {
+			channel->slice[i]->INTE &= ~(0x01UL << CCU4_CC4_INTE_PME_Pos);
+		}
+	}
+	channel->repeat = segment->repeat;
+	//Shadow transfer set enable
+	channel->module->GCSS |= 0x01UL << CCU4_GCSS_S0SE_Pos;
+	channel->module->GCSS |= 0x01UL << CCU4_GCSS_S1SE_Pos;
+	channel->module->GCSS |= 0x01UL << CCU4_GCSS_S2SE_Pos;
+	channel->module->GCSS |= 0x01UL << CCU4_GCSS_S0PSE_Pos;
+	channel->module->GCSS |= 0x01UL << CCU4_GCSS_S1PSE_Pos;
+	channel->module->GCSS |= 0x01UL << CCU4_GCSS_S2PSE_Pos;
+	//Starts the timer
+	for (i = 0; i < segment->slices; i++) {
+		channel->slice[i]->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
+	}
+	return;
+}
+
+/*
+ * \brief timer_period() returns the planned duration of a timer request, i.e.
+ * the period of a periodic timer.
+ *
+ * \param const timer_channel_t *channel timer to be read
+ * \return planned fCCU ticks
+ */
+
+static uint64_t timer_period (const timer_channel_t *channel)
+{
+	return channel->ticks + channel->error;
+}
+
+/*
+ * \brief timer_schedule() sets the expected expiration of a timer which is
+ * (re)started now.
+ *
+ * \param timer_channel_t *channel timer to be started
+ * \return none
+ */
+
+static void timer_schedule (timer_channel_t *channel)
+{
+	channel->deadline.expected = (timer_timestamp() + timer_period(channel)) & 
+	                             TIMER_STAMP_MASK;
+	channel->deadline.pending = 0;
+	return;
+}
+
+/*
+ * \brief timer_late() returns how long the expected expiration of a timer has
+ * passed at a timestamp.
+ *
+ * \param const timer_channel_t *channel timer to be checked
+ * \param uint64_t now timestamp
+ * \return lateness in fCCU ticks, 0 if the expiration is still ahead
+ */
+
+static uint64_t timer_late (const timer_channel_t *channel, uint64_t now)
+{
+	uint64_t late = (now - channel->deadline.expected) & TIMER_STAMP_MASK;
+
+	return (late > (TIMER_STAMP_MASK >> 1)) ? 0 : late;
+}
+
+/*
+ * \brief timer_start() plans a timer request and starts the first segment.
+ *
+ * \param timer_channel_t *channel timer to be started
+ * \param uint64_t ticks duration in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks
+ * \return 0 if the timer was started, or 1 if ticks is zero.
+ */
+
+static uint8_t timer_start (timer_channel_t *channel, uint64_t ticks, 
+                            uint64_t resolution)
+{
+	if (ticks == 0) {
+		return 1;
+	}
+	timer_halt(channel);
+	channel->ticks = ticks;
+	channel->resolution = resolution;
+	timer_plan(channel, ticks, resolution);
+	timer_timestamp_update();
+	timer_schedule(channel);
+	timer_load(channel);
+	return 0;
+}
+
+/*
+ * \brief timer_elapsed() returns the fCCU ticks counted by the slices of the
+ * current segment since its last period match.
+ *
+ * \param timer_channel_t *channel timer to be read
+ * \return elapsed fCCU ticks
+ */
+
+static uint64_t timer_elapsed (timer_channel_t *channel)
+{
+	const timer_segment_t *segment = &channel->segment[channel->current];
+	uint64_t elapsed = 0;
+	uint64_t scale = 1;
+	uint8_t i;
+
+	for (i = 0; i < segment->slices; i++) {
+		elapsed += (channel->slice[i]->TIMER & CCU4_CC4_TIMER_TVAL_Msk) * scale;
+		scale *= segment->period[i] + 1UL;
+	}
+	return elapsed << segment->prescaler;
+}
+
+/*
+ * \brief timer_lateness() records the lateness of an expiration and the 
+ * periods which passed without interrupt, and raises the lateness callback 
+ * if the threshold is exceeded.
+ *
+ * \param timer_channel_t *channel timer which expired
+ * \param uint64_t late lateness in fCCU ticks
+ * \param uint32_t missed periods passed without interrupt
+ * \return none
+ */
+
+static void timer_lateness (timer_channel_t *channel, uint64_t late, 
+                            uint32_t missed)
+{
+	timer_deadline_t *deadline = &channel->deadline;
+	uint32_t value = (late > UINT32_MAX) ? UINT32_MAX : (uint32_t) late;
+
+	deadline->fires++;
+	deadline->misses += missed;
+	deadline->late_last = value;
+	if (value > deadline->late_max) {
+		deadline->late_max = value;
+	}
+	if (deadline->threshold && (value > deadline->threshold)) {
+		deadline->misses++;
+		if (deadline->late_func) {
+			deadline->late_func(value);
+		}
+	}
+	return;
+}
+
+/*
+ * \brief timer_drop() discards a period match which is still pending while 
+ * its period is already handled in software. Only a timer of a single 
+ * hardware period can drop one; otherwise the match belongs to the next 
+ * segment or repetition.
+ *
+ * \param timer_channel_t *channel periodic timer
+ * \return none
+ */
+
+static void timer_drop (timer_channel_t *channel)
+{
+	const timer_segment_t *segment = &channel->segment[0];
+
+	if ((channel->segments == 1) && (segment->repeat == 1)) {
+		channel->slice[segment->slices - 1]->SWR = 0x01UL << CCU4_CC4_SWR_RPM_Pos;
+		NVIC_ClearPendingIRQ (channel->irq);
+	}
+	return;
+}
+
+/*
+ * \brief timer_advance() is called from the interrupt service routine on a
+ * period match of the top slice. The software overflow counter is decremented
+ * while the hardware keeps running; once a segment is complete the next one is
+ * loaded. On expiration the lateness against the expected expiration is 
+ * recorded. A periodic timer is restarted and its expected expiration is 
+ * advanced by whole periods, the missed ones included; with 
+ * TIMER_POLICY_CATCH_UP the missed periods are left to timer_overrun() to be
+ * called back. A single segment keeps running in hardware, so its period does
+ * not drift with the interrupt latency; several segments are restarted here,
+ * so their schedule starts again from the restart.
+ *
+ * \param timer_channel_t *channel timer which raised the interrupt
+ * \return true if the request is still running, or false if it has expired.
+ */
+
+_Bool timer_advance (timer_channel_t *channel)
+{
+	const timer_segment_t *segment = &channel->segment[channel->current];
+	timer_deadline_t *deadline = &channel->deadline;
+	uint64_t period, late;
+	uint32_t missed = 0;
+
+	//Period match status clear of the top slice, the match is handled below
+	channel->slice[segment->slices - 1]->SWR = 0x01UL << CCU4_CC4_SWR_RPM_Pos;
+	if (channel->repeat > 1) {
+		channel->repeat--;
+		return true;
+	}
+	if (channel->current + 1 < channel->segments) {
+		timer_halt(channel);
+		channel->current++;
+		timer_load(channel);
+		return true;
+	}
+	late = 0;
+	period = timer_period(channel);
+	if (deadline->policy != TIMER_POLICY_OFF) {
+		late = timer_late(channel, timer_timestamp());
+	}
+	if (channel->periodic && (late >= period)) {
+		missed = (late / period > UINT32_MAX) ? UINT32_MAX : late / period;
+	}
+	timer_lateness(channel, late, missed);
+	if (channel->periodic == false) {
+		timer_halt(channel);
+		channel->current++;
+		timer_timestamp_update();
+		return false;
+	}
+	if (channel->segments > 1) {
+		timer_halt(channel);
+		channel->current = 0;
+		timer_schedule(channel);
+		timer_load(channel);
+	} else {
+		channel->repeat = segment->repeat;
+		deadline->expected = (deadline->expected + (missed + 1ULL) * period) & 
+		                     TIMER_STAMP_MASK;
+		if (missed) {
+			timer_drop(channel);
+		}
+	}
+	if (deadline->policy == TIMER_POLICY_CATCH_UP) {
+		deadline->pending = missed;
+	}
+	return false;
+}
+
+/*
+ * \brief timer_overrun() is called from the interrupt service routine after
+ * the callback of a periodic timer. While missed periods are to be caught up
+ * the callback is requested again. Afterwards the timestamp is compared with
+ * the next expected expiration: if it has passed, the callback overran its 
+ * period. With TIMER_POLICY_SKIP the passed periods are dropped and counted 
+ * as misses, with TIMER_POLICY_CATCH_UP they are left to the next interrupt.
+ *
+ * \param timer_channel_t *channel timer which raised the interrupt
+ * \return true if the callback has to be called again for a missed period,
+ * or false if not.
+ */
+
+_Bool timer_overrun (timer_channel_t *channel)
+{
+	timer_deadline_t *deadline = &channel->deadline;
+	uint64_t period, late, skipped;
+	uint64_t now;
+
+	if ((channel->periodic == false) || (deadline->policy == TIMER_POLICY_OFF)) {
+		return false;
+	}
+	if (deadline->pending) {
+		deadline->pending--;
+		deadline->fires++;
+		return true;
+	}
+	now = timer_timestamp();
+	if (((now - deadline->expected) & TIMER_STAMP_MASK) > (TIMER_STAMP_MASK >> 1)) {
+		return false;
+	}
+	deadline->overruns++;
+	if ((deadline->policy == TIMER_POLICY_SKIP) && (channel->segments == 1) && 
+	    (channel->segment[0].repeat == 1)) {
+		late = timer_late(channel, now);
+		period = timer_period(channel);
+		skipped = late / period + 1;
+		deadline->expected = (deadline->expected + skipped * period) & 
+		                     TIMER_STAMP_MASK;
+		deadline->misses += (skipped > UINT32_MAX) ? UINT32_MAX : (uint32_t) skipped;
+		timer_drop(channel);
+	}
+	return false;
+}
+
+/*
+ * \brief timer_stop() stops a timer request. The slices are halted, and a 
+ * periodic timer is neither restarted nor are its missed periods called back
+ * any more, also if it is stopped from its own callback. The timestamp is 
+ * released if no other supervised timer is armed.
+ *
+ * \param timer_channel_t *channel timer to be stopped
+ * \return none
+ */
+
+void timer_stop (timer_channel_t *channel)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	timer_halt(channel);
+	channel->current = channel->segments;
+	channel->periodic = false;
+	channel->deadline.pending = 0;
+	timer_timestamp_update();
+	__set_PRIMASK(primask);
+	return;
+}
+
+/*
+ * \brief timer_running() reports whether a timer has a request in progress.
+ *
+ * \param timer_channel_t *channel timer to be checked
+ * \return true if the timer is running, false if it is stopped or expired.
+ */
+
+_Bool timer_running (timer_channel_t *channel)
+{
+	return (channel->slice[0]->TCST & CCU4_CC4_TCST_TRB_Msk) && 
+	       (channel->current < channel->segments);
+}
+
+/*
+ * \brief timer_remaining() returns the fCCU ticks left until a running timer
+ * request expires, read back from the counters of the current segment.
+ *
+ * \param timer_channel_t *channel timer to be read
+ * \return remaining fCCU ticks, or 0 if the timer is not running.
+ */
+
+static uint64_t timer_remaining (timer_channel_t *channel)
+{
+	const timer_segment_t *segment;
+	uint64_t remaining;
+	uint64_t scale = 1;
+	uint8_t i;
+
+	if (timer_running (channel) == false) {
+		return 0;
+	}
+	segment = &channel->segment[channel->current];
+	for (i = 0; i < segment->slices; i++) {
+		scale *= segment->period[i] + 1UL;
+	}
+	remaining = ((scale * channel->repeat) << segment->prescaler) - 
+	            timer_elapsed (channel);
+	for (i = channel->current + 1; i < channel->segments; i++) {
+		segment = &channel->segment[i];
+		remaining += ((uint64_t) (segment->period[0] + 1UL) * 
+		              (segment->period[1] + 1UL) * (segment->period[2] + 1UL) * 
+		              segment->repeat) << segment->prescaler;
+	}
+	return remaining;
+}
+
+/*
+ * \brief timer_deadline_configuration() sets the lateness threshold, the 
+ * overrun policy and the lateness callback of a timer and clears its 
+ * deadline counters.
+ *
+ * \param timer_channel_t *channel timer to be configured
+ * \param uint32_t threshold lateness threshold in fCCU ticks, 0 disables it
+ * \param uint8_t policy TIMER_POLICY_CATCH_UP or TIMER_POLICY_SKIP, or
+ * TIMER_POLICY_OFF to end the supervision and release the timestamp
+ * \param void (*func)(uint32_t late) lateness callback, or NULL
+ * \return none
+ */
+
+void timer_deadline_configuration (timer_channel_t *channel, uint32_t threshold,
+                                   uint8_t policy, void (* func) (uint32_t late))
+{
+	uint32_t primask = __get_PRIMASK();
+	uint64_t remaining;
+
+	__disable_irq();
+	channel->deadline.fires = 0;
+	channel->deadline.late_last = 0;
+	channel->deadline.late_max = 0;
+	channel->deadline.misses = 0;
+	channel->deadline.overruns = 0;
+	channel->deadline.pending = 0;
+	channel->deadline.threshold = threshold;
+	channel->deadline.policy = policy;
+	channel->deadline.late_func = func;
+	timer_timestamp_update();
+	//A running request is supervised from its remaining time on
+	if (timer_supervised (channel)) {
+		remaining = timer_remaining (channel);
+		channel->deadline.expected = (timer_timestamp() + 
+		                              (remaining ? remaining : timer_period (channel))) & 
+		                             TIMER_STAMP_MASK;
+	}
+	__set_PRIMASK(primask);
+	return;
+}
+
+/*
+ * \brief configure_timer_clock() is a driver function to be called whenever
+ * the SCU changes fCCU. The conversion factors are recomputed, and running 
+ * delays, timeouts and the task period are re-planned for the new clock, so 
+ * they keep their remaining time. A periodic timeout is restarted with its 
+ * rescaled period.
+ *
+ * \param uint32_t fccu_hz new fCCU in Hz
+ * \return none
+ */
+
+void configure_timer_clock (uint32_t fccu_hz)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t from_hz = timer_clock_hz;
+	uint64_t delay, timeout, threshold;
+
+	__disable_irq();
+	delay = timer_remaining (&timer_delay);
+	timeout = timer_remaining (&timer_timeout);
+
+	timer_clock_hz = fccu_hz;
+	timer_scale (&timer_scale_us, fccu_hz, 1000000UL);
+	timer_scale (&timer_scale_ms, fccu_hz, 1000UL);
+
+	//A request which rounds to zero ticks still has to raise its interrupt
+	if (delay) {
+		delay = timer_rescale (delay, from_hz, fccu_hz);
+		timer_start (&timer_delay, delay ? delay : 1, 
+		             timer_rescale (timer_delay.resolution, from_hz, fccu_hz));
+	}
+	if (timeout) {
+		if (timer_timeout.periodic) {
+			timeout = timer_timeout.ticks;
+		}
+		timeout = timer_rescale (timeout, from_hz, fccu_hz);
+		timer_start (&timer_timeout, timeout ? timeout : 1, 
+		             timer_rescale (timer_timeout.resolution, from_hz, fccu_hz));
+	}
+	//Saturated at the 32 bit tick range like the lateness they are compared to
+	threshold = timer_rescale (timer_delay.deadline.threshold, from_hz, fccu_hz);
+	timer_delay.deadline.threshold = (threshold > UINT32_MAX) ? UINT32_MAX : (uint32_t) threshold;
+	threshold = timer_rescale (timer_timeout.deadline.threshold, from_hz, fccu_hz);
+	timer_timeout.deadline.threshold = (threshold > UINT32_MAX) ? UINT32_MAX : (uint32_t) threshold;
+	if (timer_task_ticks) {
+		CCU42_CC40->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
+		configure_timer_task (timer_rescale (timer_task_ticks, from_hz, fccu_hz));
+	}
+	__set_PRIMASK(primask);
+	return;
+}
+
 /*
  * \brief _delayus_configuration() is a driver function to configure the CCU4 
  * capture and compare unit for a microseconds time delay.
@@ -223,36 +1388,7 @@ _Bool configure_timer_timeout (void)
 
 uint8_t _delayus_configuration (uint8_t us)
 {
-	//Define 16Bit Variable and multiply 120 (1us) with us
-	uint16_t value_us = 0;
-	value_us = 120 * us;
-	//Define Prescale Value to fout/1 (0000B)
-	//****CC40****
-	CCU40_CC40->PSC = 0x00UL << CCU4_CC4_PSC_PSIV_Pos;
-	//****CC40****
-	CCU40_CC41->PSC = 0x00UL << CCU4_CC4_PSC_PSIV_Pos;
-	//****CC40****
-	CCU40_CC42->PSC = 0x00UL << CCU4_CC4_PSC_PSIV_Pos;
-	//Load Period Shadow Register
-	CCU40_CC40->PRS = value_us;
-	CCU40_CC41->PRS = 0;
-	CCU40_CC42->PRS = 0;
-	//Slice 0 shadow transfer set enable
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S0SE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S1SE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S2SE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S3SE_Pos;
-
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S0PSE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S1PSE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S2PSE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S3PSE_Pos;
-	//Starts the timer
-	CCU40_CC40->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	CCU40_CC41->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	CCU40_CC42->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	//CCU40_CC43->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	return 0;
+	return _delay_ticks_configuration (timer_us_to_ticks (us), 0);
 }
 
 /*
@@ -267,40 +1403,11 @@ uint8_t _delayus_configuration (uint8_t us)
 
 uint8_t _delay_configuration (uint8_t min, uint8_t sec, uint8_t ms)
 {
-	//Define 64Bit Variable
 	uint64_t value_delay = 0;
-	uint16_t value_LSB = 0;
-	uint16_t value_MSB = 0;
-
-	value_delay = (ms * 120000) + (sec * 120000000) + (min * 7200000000);
-
-	value_LSB = value_delay / 65535;
 
-	if (value_delay <= 4294967296) {
-		//Load Period Shadow Register
-		CCU40_CC40->PRS = 65535;
-		CCU40_CC41->PRS = value_LSB;
-		CCU40_CC42->PRS = 0;
-	}
-	if (value_delay >= 4294967296) {
-		value_MSB = value_delay / (65535 * 32768) * 2;
-		//Load Period Shadow Register
-		CCU40_CC40->PRS = 65535;
-		CCU40_CC41->PRS = 32768;
-		CCU40_CC42->PRS = value_MSB;
-	}
-	//Slice 0 shadow transfer set enable
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S0SE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S1SE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S2SE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S0PSE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S1PSE_Pos;
-	CCU40->GCSS |= 0x01UL << CCU4_GCSS_S2PSE_Pos;
-	//Starts the timer
-	CCU40_CC40->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	CCU40_CC41->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	CCU40_CC42->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	return 0;
+	value_delay = timer_ms_to_ticks ((uint32_t) min * 60000 + 
+	                                 (uint32_t) sec * 1000 + ms);
+	return _delay_ticks_configuration (value_delay, 0);
 }
 
 /*
@@ -319,39 +1426,92 @@ uint8_t _delay_configuration (uint8_t min, uint8_t sec, uint8_t ms)
 uint8_t _timeout_configuration (uint8_t min, uint8_t sec, uint8_t ms, 
                                 void (* func) (void))
 {
-	//Define 64Bit Variable and multiply 120 (1us) with us
 	uint64_t value_delay = 0;
-	uint16_t value_LSB = 0;
-	uint16_t value_MSB = 0;
-	value_delay = (ms * 120000) + (sec * 120000000) + (min * 7200000000);
 
-	value_LSB = value_delay / 65535;
+	value_delay = timer_ms_to_ticks ((uint32_t) min * 60000 + 
+	                                 (uint32_t) sec * 1000 + ms);
+	return _timeout_ticks_configuration (value_delay, 0, func);
+}
 
-	if (value_delay <= 4294967296) {
-		//Load Period Shadow Register
-		CCU41_CC40->PRS = 65535;
-		CCU41_CC41->PRS = value_LSB;
-		CCU41_CC42->PRS = 0;
-	}
-	if (value_delay >= 4294967296) {
-		value_MSB = value_delay / (65535 * 32768) * 2;
-		//Load Period Shadow Register
-		CCU41_CC40->PRS = 65535;
-		CCU41_CC41->PRS = 32768;
-		CCU41_CC42->PRS = value_MSB;
+/*
+ * \brief _delay_ticks_configuration() is a driver function to configure the
+ * CCU40 unit for a delay of any number of fCCU ticks. The prescaler and the
+ * number of concatenated slices are chosen to meet the given resolution.
+ *
+ * \param uint64_t ticks Delay in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks, 0 for exact
+ * \return 0 after successful configuration, or 1 if ticks is zero.
+ */
+
+uint8_t _delay_ticks_configuration (uint64_t ticks, uint64_t resolution)
+{
+	return timer_start (&timer_delay, ticks, resolution);
+}
+
+/*
+ * \brief timer_timeout_start() sets the callback of the timeout and starts it
+ * with interrupts disabled, so even a request of one tick can not expire 
+ * before its callback is in place. A match of the previous request which is
+ * still pending is dropped.
+ *
+ * \param uint64_t ticks Timeout or period in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks, 0 for exact
+ * \param _Bool periodic restart after every expiration
+ * \param void (*func)(void) function pointer address
+ * \return 0 after successful configuration, or 1 if ticks is zero.
+ */
+
+static uint8_t timer_timeout_start (uint64_t ticks, uint64_t resolution, 
+                                    _Bool periodic, void (* func) (void))
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t result;
+
+	if (ticks == 0) {
+		return 1;
 	}
-	//Slice 0 shadow transfer set enable
-	CCU41->GCSS |= 0x01UL << CCU4_GCSS_S0SE_Pos;
-	CCU41->GCSS |= 0x01UL << CCU4_GCSS_S1SE_Pos;
-	CCU41->GCSS |= 0x01UL << CCU4_GCSS_S2SE_Pos;
-	CCU41->GCSS |= 0x01UL << CCU4_GCSS_S0PSE_Pos;
-	CCU41->GCSS |= 0x01UL << CCU4_GCSS_S1PSE_Pos;
-	CCU41->GCSS |= 0x01UL << CCU4_GCSS_S2PSE_Pos;
-	//Starts the timer
-	CCU41_CC40->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	CCU41_CC41->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	CCU41_CC42->TCSET = 0x01UL << CCU4_CC4_TCSET_TRBS_Pos;
-	return 0;
+	__disable_irq();
+	timer_stop(&timer_timeout);
+	NVIC_ClearPendingIRQ (timer_timeout.irq);
+	function_adress = func;
+	timer_timeout.periodic = periodic;
+	result = timer_start (&timer_timeout, ticks, resolution);
+	__set_PRIMASK(primask);
+	return result;
+}
+
+/*
+ * \brief _timeout_ticks_configuration() is a driver function to configure the
+ * CCU41 unit for a timeout of any number of fCCU ticks. The prescaler and the
+ * number of concatenated slices are chosen to meet the given resolution.
+ *
+ * \param uint64_t ticks Delay in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks, 0 for exact
+ * \param void (*func)(void) callback, set before the timer is started
+ * \return 0 after successful configuration, or 1 if ticks is zero.
+ */
+
+uint8_t _timeout_ticks_configuration (uint64_t ticks, uint64_t resolution, 
+                                      void (* func) (void))
+{
+	return timer_timeout_start (ticks, resolution, false, func);
+}
+
+/*
+ * \brief _timeout_periodic_configuration() is a driver function to configure
+ * the CCU41 unit for a timeout which expires every ticks fCCU ticks until it
+ * is reset.
+ *
+ * \param uint64_t ticks Period in fCCU ticks
+ * \param uint64_t resolution maximum timing error in fCCU ticks, 0 for exact
+ * \param void (*func)(void) callback, set before the timer is started
+ * \return 0 after successful configuration, or 1 if ticks is zero.
+ */
+
+uint8_t _timeout_periodic_configuration (uint64_t ticks, uint64_t resolution, 
+                                         void (* func) (void))
+{
+	return timer_timeout_start (ticks, resolution, true, func);
 }
 
 /*
@@ -364,12 +1524,7 @@ uint8_t _timeout_configuration (uint8_t min, uint8_t sec, uint8_t ms,
 
 void reset_timer()
 {
-	CCU40_CC40-> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
-	CCU40_CC40 -> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos; //Timer clear
-	CCU40_CC41-> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
-	CCU40_CC41 -> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos; //Timer clear
-	CCU40_CC42-> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
-	CCU40_CC42 -> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos; //Timer clear
+	timer_stop(&timer_delay);
 	return;
 }
 
@@ -383,12 +1538,7 @@ void reset_timer()
 
 void reset_timer_timeout()
 {
-	CCU41_CC40-> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
-	CCU41_CC40 ->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos;  //Timer clear
-	CCU41_CC41-> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
-	CCU41_CC41 ->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos;  //Timer clear
-	CCU41_CC42-> TCCLR = 0x01UL << CCU4_CC4_TCCLR_TRBC_Pos; //Timer run bit clear
-	CCU41_CC42 ->TCCLR = 0x01UL << CCU4_CC4_TCCLR_TCC_Pos;  //Timer clear
+	timer_stop(&timer_timeout);
 	return;
 }
 
@@ -15,20 +15,161 @@
 #include "GPIO.h"
 
 
-extern _Bool interrupt_enable;
+/******************************************************************** DEFINES */
+#define TIMER_SLICES            3       //Concatenated slices CC40..CC42
+#define TIMER_SEGMENTS_MAX      4       //Segments of one timer request
+#define TIMER_PRESCALER_MAX     15      //PSIV, fCCU / 32768
+#define TIMER_SEARCH_MAX        128     //Divisor candidates of one plan
+#define TIMER_POLICY_OFF        0       //No deadline supervision
+#define TIMER_POLICY_CATCH_UP   1       //Run the callback for every missed period
+#define TIMER_POLICY_SKIP       2       //Drop the missed periods
+#define TIMER_GROUP_MAX         8       //Slices of one synchronised group
+#define TIMER_STAMP_MASK        0xFFFFFFFFFFFFULL //48 bit timestamp, CCU42 CC41..CC43
+#ifndef TIMER_CLOCK_HZ
+#define TIMER_CLOCK_HZ          120000000UL     //Default fCCU
+#endif
+
+/*
+ * One hardware segment of a timer request. The lowest slices CC40.. run 
+ * concatenated with the given prescaler and period values and the segment 
+ * ends after repeat period matches of the top used slice. Runs longer than 
+ * the 48 bit hardware range are covered by counting these period matches in 
+ * software.
+ */
+typedef struct {
+	uint16_t period[TIMER_SLICES];  //PRS value for CC40..CC42
+	uint8_t  slices;                //Concatenated slices in use (1..3)
+	uint8_t  prescaler;             //PSIV, fCCU / 2^prescaler
+	uint32_t repeat;                //Period matches until the segment ends
+} timer_segment_t;
+
+/*
+ * Conversion factor from a time unit to fCCU ticks as fixed-point number, so
+ * no divide is required at call time: ticks = x * whole + (x * frac) >> 32.
+ */
+typedef struct {
+	uint32_t whole;                 //Integer ticks per unit
+	uint32_t frac;                  //Fractional ticks per unit, Q0.32
+} timer_scale_t;
+
+/*
+ * Initializer of a timer_scale_t for fCCU hz and per_second units per second.
+ * The fraction is rounded to nearest, both for the static defaults and for 
+ * the factors recomputed at run time.
+ */
+#define TIMER_SCALE(hz, per_second)                                             \
+	{ (uint32_t) ((hz) / (per_second)),                                     \
+	  (uint32_t) ((((uint64_t) ((hz) % (per_second)) << 32) + (per_second) / 2) / \
+	              (per_second)) }
+
+/*
+ * Deadline bookkeeping of one timer. The expected expiration is kept in 
+ * software on the free-running timestamp and advanced by the period, so the
+ * lateness of an expiration and the periods missed meanwhile are known in 
+ * full, not only modulo the period. Periods and lateness are limited to half
+ * the timestamp range (2^47 ticks, 13 days at 120 MHz). The timestamp only
+ * runs while a timer with a policy other than TIMER_POLICY_OFF is armed, so
+ * without supervision the threshold is not checked and no lateness recorded.
+ */
+typedef struct {
+	uint64_t expected;              //Timestamp of the next expiration
+	volatile uint32_t pending;      //Missed periods still to be caught up
+	uint32_t fires;                 //Expirations serviced
+	uint32_t late_last;             //Lateness of the last expiration in ticks
+	uint32_t late_max;              //Maximum lateness in ticks
+	uint32_t misses;                //Expirations later than the threshold and
+	                                //periods which passed without interrupt
+	uint32_t overruns;              //Callbacks still running at the next 
+	                                //expiration
+	uint32_t threshold;             //Lateness threshold in ticks, 0 disables
+	uint8_t  policy;                //TIMER_POLICY_OFF, _CATCH_UP or _SKIP
+	void   (* late_func )( uint32_t late );  //Called above the threshold
+} timer_deadline_t;
+
+/*
+ * State of one CCU4 module used as concatenated 48 bit timer.
+ */
+typedef struct {
+	CCU4_GLOBAL_TypeDef *module;
+	CCU4_CC4_TypeDef    *slice[TIMER_SLICES];
+	IRQn_Type            irq;
+	timer_segment_t      segment[TIMER_SEGMENTS_MAX];
+	uint8_t              segments;
+	volatile uint8_t     current;
+	volatile uint32_t    repeat;
+	uint64_t             ticks;     //Requested fCCU ticks
+	uint64_t             resolution; //Requested resolution in fCCU ticks
+	int64_t              error;     //Planned minus requested fCCU ticks
+	_Bool                periodic;  //Restart after every expiration
+	timer_deadline_t     deadline;
+} timer_channel_t;
+
+/*
+ * One slice of a synchronised group. The output is active from the compare
+ * value to the end of the period; the phase preloads the counter, so the 
+ * slice runs ahead of the group start by this number of prescaled ticks.
+ */
+typedef struct {
+	uint8_t  module;                //0..3 for CCU40..CCU43
+	uint8_t  slice;                 //0..3 for CC4x0..CC4x3
+	uint16_t phase;                 //Phase offset in prescaled ticks
+	uint16_t compare;               //CRS value
+} timer_group_slice_t;
+
+/*
+ * Group of slices across CCU40..CCU43 sharing period and prescaler, started
+ * together by the SCU global start signal. Slices of several modules need 
+ * prescaler 0, as the prescalers of the modules are not aligned.
+ */
+typedef struct {
+	timer_group_slice_t slice[TIMER_GROUP_MAX];
+	uint8_t  slices;
+	uint8_t  prescaler;             //PSIV, fCCU / 2^prescaler
+	uint16_t period;                //PRS value shared by all slices
+} timer_group_t;
+
+/******************************************************************** GLOBALS */
+extern volatile _Bool interrupt_enable;
 extern void(*function_adress)(void);
 
-/******************************************************************** DEFINES */
+extern timer_channel_t timer_delay;
+extern timer_channel_t timer_timeout;
+
+extern uint32_t timer_clock_hz;
+extern timer_scale_t timer_scale_us;
+extern timer_scale_t timer_scale_ms;
 
 /******************************************************** FUNCTION PROTOTYPES */
 _Bool configure_timer(void);
 _Bool configure_timer_timeout(void);
+_Bool configure_timer_task(uint64_t ticks);
+void timer_task_duty(uint8_t percent);
 
 void SCU_configuration(void);
+void configure_timer_clock(uint32_t fccu_hz);
+
+uint64_t timer_timestamp(void);
+uint64_t timer_us_to_ticks(uint32_t us);
+uint64_t timer_ms_to_ticks(uint32_t ms);
 
 uint8_t _delayus_configuration(uint8_t us);
 uint8_t _delay_configuration ( uint8_t min, uint8_t sec, uint8_t ms );
 uint8_t _timeout_configuration ( uint8_t min, uint8_t sec, uint8_t ms, void (* func )( void ) );
+uint8_t _delay_ticks_configuration ( uint64_t ticks, uint64_t resolution );
+uint8_t _timeout_ticks_configuration ( uint64_t ticks, uint64_t resolution, void (* func )( void ) );
+uint8_t _timeout_periodic_configuration ( uint64_t ticks, uint64_t resolution, void (* func )( void ) );
+
+_Bool timer_advance(timer_channel_t *channel);
+_Bool timer_overrun(timer_channel_t *channel);
+_Bool configure_timer_group(const timer_group_t *group);
+void timer_group_start(const timer_group_t *group);
+void timer_group_stop(const timer_group_t *group);
+void timer_group_update(timer_group_t *group, const uint16_t *compare);
+uint8_t timer_group_peak(const timer_group_t *group);
+
+void timer_deadline_configuration(timer_channel_t *channel, uint32_t threshold, uint8_t policy, void (* func )( uint32_t late ));
+void timer_stop(timer_channel_t *channel);
+_Bool timer_running(timer_channel_t *channel);
 
 void reset_timer(void);
 void reset_timer_timeout(void);
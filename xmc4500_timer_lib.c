@@ -12,7 +12,7 @@
 #include <xmc4500_timer_lib.h>
 
 /******************************************************************** GLOBALS */
-_Bool interrupt_enable;
+volatile _Bool interrupt_enable;
 /********************************************************************/
 
 void (*function_adress) (void) = NULL;
@@ -20,8 +20,9 @@ void (*function_adress) (void) = NULL;
 /*
  * \brief CCU40_0_IRQHandler() CCU40 interrupt handler which is called if the 
  * CCU4 capture and compare unit is configured into timer mode. Within the 
- * interrupt service routine a variable is set which is required to signal the 
- * completion of the configured delay.
+ * interrupt service routine the next segment of the delay is started, or a 
+ * variable is set which is required to signal the completion of the 
+ * configured delay.
  *
  * \param none
  * \return none
@@ -29,14 +30,19 @@ void (*function_adress) (void) = NULL;
 
 void CCU40_0_IRQHandler (void)
 {
-	interrupt_enable = 1;
+	if (timer_advance (&timer_delay) == false) {
+		interrupt_enable = 1;
+	}
 }
 
 /*
  * \brief CCU41_0_IRQHandler() CCU41 interrupt handler which is called if the 
  * CCU4 capture and compare unit is configured into timeout mode. Within the 
- * interrupt service routine the CCU41 unit is reseted from timeout mode and if 
- * a valid function pointer is transferred the function pointer is called.
+ * interrupt service routine the next segment of the timeout is started. After 
+ * the last segment the CCU41 unit is reseted from timeout mode and if a valid 
+ * function pointer is transferred the function pointer is called. For a 
+ * periodic timeout it is called again for every missed period to be caught
+ * up, and checked for an overrun of its period.
  *
  * \param none
  * \return none
@@ -44,9 +50,13 @@ void CCU40_0_IRQHandler (void)
 
 void CCU41_0_IRQHandler (void)
 {
-	reset_timer_timeout();
-	if (function_adress)
-		function_adress();
+	if (timer_advance (&timer_timeout) == true) {
+		return;
+	}
+	do {
+		if (function_adress)
+			function_adress();
+	} while (timer_overrun (&timer_timeout));
 }
 
 /*
@@ -86,6 +96,24 @@ _Bool setup_timer_timeout (void)
 	return true;
 }
 
+/*
+ * \brief update_timer_clock() function has to be called whenever the SCU 
+ * clock setup changes fCCU. Within this function the driver recomputes the 
+ * conversion from time to ticks and re-plans running delays and timeouts.
+ *
+ * \param uint32_t fccu_hz new fCCU in Hz
+ * \return true if the clock was updated, or false if fccu_hz is zero.
+ */
+
+_Bool update_timer_clock (uint32_t fccu_hz)
+{
+	if (fccu_hz == 0) {
+		return false;
+	}
+	configure_timer_clock (fccu_hz);
+	return true;
+}
+
 /*
  * \brief _delayus() function is called by the main-routine. Within this 
  * function the the driver function _delayus_configuration() is called which 
@@ -167,4 +195,192 @@ uint8_t _timeout (uint8_t min, uint8_t sec, uint8_t ms, void (* func) (void))
 	return 1;
 }
 
+/*
+ * \brief delay_ms() is a blocking delay for a given number of milliseconds. 
+ * Unlike _delay() the delay is not limited to one hour; durations beyond the 
+ * 48 bit hardware range are covered by counting overflows in software.
+ *
+ * \param uint32_t ms Delay in milliseconds
+ * \return 0 if the delay_ms() was successful, or 1 if not.
+ */
+
+uint8_t delay_ms (uint32_t ms)
+{
+	return delay_ticks_res (timer_ms_to_ticks (ms), 0);
+}
+
+/*
+ * \brief delay_ms_res() is a blocking delay for a given number of 
+ * milliseconds which may deviate by up to res_us microseconds. The coarser the
+ * resolution the larger the prescaler and the fewer slices are used.
+ *
+ * \param uint32_t ms Delay in milliseconds
+ * \param uint32_t res_us Required resolution in microseconds
+ * \return 0 if the delay_ms_res() was successful, or 1 if not.
+ */
+
+uint8_t delay_ms_res (uint32_t ms, uint32_t res_us)
+{
+	return delay_ticks_res (timer_ms_to_ticks (ms), 
+	                        timer_us_to_ticks (res_us));
+}
+
+/*
+ * \brief delay_ticks() is a blocking delay for a given number of fCCU ticks.
+ *
+ * \param uint64_t ticks Delay in fCCU ticks
+ * \return 0 if the delay_ticks() was successful, or 1 if not.
+ */
+
+uint8_t delay_ticks (uint64_t ticks)
+{
+	return delay_ticks_res (ticks, 0);
+}
+
+/*
+ * \brief delay_ticks_res() is a blocking delay for a given number of fCCU 
+ * ticks which may deviate by up to res ticks.
+ *
+ * \param uint64_t ticks Delay in fCCU ticks
+ * \param uint64_t res Required resolution in fCCU ticks
+ * \return 0 if the delay_ticks_res() was successful, or 1 if not.
+ */
+
+uint8_t delay_ticks_res (uint64_t ticks, uint64_t res)
+{
+	if (_delay_ticks_configuration (ticks, res) != 0) {
+		return 1;
+	}
+	while (!interrupt_enable) {
+	}
+	interrupt_enable = 0;
+	reset_timer();
+	return 0;
+}
+
+/*
+ * \brief timeout_ms() is a non-blocking timeout for a given number of 
+ * milliseconds. After the timeout the callback function func() is invoked 
+ * within the CCU41_0_IRQHandler interrupt service routine.
+ *
+ * \param uint32_t ms Timeout in milliseconds
+ * \param void (*func)(void) function pointer address
+ * \return 0 if the timeout_ms() was successful, or 1 if not.
+ */
+
+uint8_t timeout_ms (uint32_t ms, void (* func) (void))
+{
+	return timeout_ticks_res (timer_ms_to_ticks (ms), 0, func);
+}
+
+/*
+ * \brief timeout_ms_res() is a non-blocking timeout for a given number of 
+ * milliseconds which may deviate by up to res_us microseconds.
+ *
+ * \param uint32_t ms Timeout in milliseconds
+ * \param uint32_t res_us Required resolution in microseconds
+ * \param void (*func)(void) function pointer address
+ * \return 0 if the timeout_ms_res() was successful, or 1 if not.
+ */
+
+uint8_t timeout_ms_res (uint32_t ms, uint32_t res_us, void (* func) (void))
+{
+	return timeout_ticks_res (timer_ms_to_ticks (ms), 
+	                          timer_us_to_ticks (res_us), func);
+}
+
+/*
+ * \brief timeout_ticks() is a non-blocking timeout for a given number of fCCU
+ * ticks. After the timeout the callback function func() is invoked within the
+ * CCU41_0_IRQHandler interrupt service routine.
+ *
+ * \param uint64_t ticks Timeout in fCCU ticks
+ * \param void (*func)(void) function pointer address
+ * \return 0 if the timeout_ticks() was successful, or 1 if not.
+ */
+
+uint8_t timeout_ticks (uint64_t ticks, void (* func) (void))
+{
+	return timeout_ticks_res (ticks, 0, func);
+}
+
+/*
+ * \brief timeout_ticks_res() is a non-blocking timeout for a given number of
+ * fCCU ticks which may deviate by up to res ticks.
+ *
+ * \param uint64_t ticks Timeout in fCCU ticks
+ * \param uint64_t res Required resolution in fCCU ticks
+ * \param void (*func)(void) function pointer address
+ * \return 0 if the timeout_ticks_res() was successful, or 1 if not.
+ */
+
+uint8_t timeout_ticks_res (uint64_t ticks, uint64_t res, void (* func) (void))
+{
+	if (_timeout_ticks_configuration (ticks, res, func) != 0) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * \brief timeout_periodic_ms() is a non-blocking timeout which expires every 
+ * ms milliseconds until reset_timer_timeout() or another timeout is set. The
+ * callback function func() is invoked within the CCU41_0_IRQHandler interrupt
+ * service routine on every expiration.
+ *
+ * \param uint32_t ms Period in milliseconds
+ * \param void (*func)(void) function pointer address
+ * \return 0 if the timeout_periodic_ms() was successful, or 1 if not.
+ */
+
+uint8_t timeout_periodic_ms (uint32_t ms, void (* func) (void))
+{
+	return timeout_periodic_ticks (timer_ms_to_ticks (ms), 0, func);
+}
+
+/*
+ * \brief timeout_periodic_ticks() is a non-blocking timeout which expires 
+ * every ticks fCCU ticks, with a period which may deviate by up to res ticks.
+ *
+ * \param uint64_t ticks Period in fCCU ticks
+ * \param uint64_t res Required resolution in fCCU ticks
+ * \param void (*func)(void) function pointer address
+ * \return 0 if the timeout_periodic_ticks() was successful, or 1 if not.
+ */
+
+uint8_t timeout_periodic_ticks (uint64_t ticks, uint64_t res, 
+                                void (* func) (void))
+{
+	if (_timeout_periodic_configuration (ticks, res, func) != 0) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * \brief timeout_deadline() configures the deadline supervision of the 
+ * timeout and clears its counters in timer_timeout.deadline. Expirations 
+ * later than threshold_us are counted as missed and reported to func(), and 
+ * the policy decides whether the callback is called for periods which passed
+ * without interrupt (TIMER_POLICY_CATCH_UP) or not (TIMER_POLICY_SKIP). The 
+ * CCU42 timestamp of the supervision only runs while the timeout is armed;
+ * TIMER_POLICY_OFF ends the supervision.
+ *
+ * \param uint32_t threshold_us Lateness threshold in microseconds, 0 disables
+ * \param uint8_t policy TIMER_POLICY_OFF, TIMER_POLICY_CATCH_UP or TIMER_POLICY_SKIP
+ * \param void (*func)(uint32_t late) lateness callback, or NULL
+ * \return none
+ */
+
+void timeout_deadline (uint32_t threshold_us, uint8_t policy, 
+                       void (* func) (uint32_t late))
+{
+	uint64_t threshold = timer_us_to_ticks (threshold_us);
+
+	//Thresholds beyond the 32 bit tick range saturate instead of wrapping
+	timer_deadline_configuration (&timer_timeout, 
+	                              (threshold > UINT32_MAX) ? UINT32_MAX : (uint32_t) threshold, 
+	                              policy, func);
+}
+
 /* EOF */
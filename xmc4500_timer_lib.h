@@ -13,10 +13,24 @@
 /******************************************************** FUNCTION PROTOTYPES */
 _Bool setup_timer(void);
 _Bool setup_timer_timeout(void);
+_Bool update_timer_clock(uint32_t fccu_hz);
 
 
 uint8_t _delayus ( uint8_t us );
 uint8_t _delay   ( uint8_t min, uint8_t sec, uint8_t ms );
 uint8_t _timeout ( uint8_t min, uint8_t sec, uint8_t ms, void (* func )( void ) );
 
+uint8_t delay_ms          ( uint32_t ms );
+uint8_t delay_ms_res      ( uint32_t ms, uint32_t res_us );
+uint8_t delay_ticks       ( uint64_t ticks );
+uint8_t delay_ticks_res   ( uint64_t ticks, uint64_t res );
+uint8_t timeout_ms        ( uint32_t ms, void (* func )( void ) );
+uint8_t timeout_ms_res    ( uint32_t ms, uint32_t res_us, void (* func )( void ) );
+uint8_t timeout_ticks     ( uint64_t ticks, void (* func )( void ) );
+uint8_t timeout_ticks_res ( uint64_t ticks, uint64_t res, void (* func )( void ) );
+
+uint8_t timeout_periodic_ms    ( uint32_t ms, void (* func )( void ) );
+uint8_t timeout_periodic_ticks ( uint64_t ticks, uint64_t res, void (* func )( void ) );
+void    timeout_deadline       ( uint32_t threshold_us, uint8_t policy, void (* func )( uint32_t late ) );
+
 #endif /* INC_XMC4500_TIMER_LIB_H_ */
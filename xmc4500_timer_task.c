@@ -0,0 +1,306 @@
+/**!
+ * @file     xmc4500_timer_task.c
+ * @version  V0.2
+ *
+ *  \brief This module supports cooperative tasks on top of the timer. Tasks
+ *  are taken from a static pool and wait for task periods, delays or the
+ *  timeout without blocking. The interrupt service routines put the tasks 
+ *  back into a ready queue which is processed by task_run() in the main loop.
+*/
+
+#include <xmc4500_timer_driver.h>
+#include <xmc4500_timer_lib.h>
+#include <xmc4500_timer_task.h>
+
+/******************************************************************** GLOBALS */
+static timer_task_t  task_pool[TIMER_TASKS_MAX];
+static timer_task_t *task_queue[TIMER_TASKS_MAX + 1];
+static volatile uint8_t task_head;
+static volatile uint8_t task_tail;
+static uint32_t task_period_us = 0;
+static timer_task_t * volatile task_timeout_waiter = NULL;
+/********************************************************************/
+
+/*
+ * \brief task_push() appends a task to the ready queue. Every task is at most
+ * once in the queue, so the queue can not overflow.
+ *
+ * \param timer_task_t *task task to be appended
+ * \return none
+ */
+
+static void task_push (timer_task_t *task)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (task->state != TASK_READY) {
+		task->state = TASK_READY;
+		task_queue[task_tail] = task;
+		task_tail = (task_tail + 1) % (TIMER_TASKS_MAX + 1);
+	}
+	__set_PRIMASK(primask);
+	return;
+}
+
+/*
+ * \brief task_pop() takes the first task from the ready queue.
+ *
+ * \param none
+ * \return the task, or NULL if no task is ready.
+ */
+
+static timer_task_t *task_pop (void)
+{
+	timer_task_t *task = NULL;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (task_head != task_tail) {
+		task = task_queue[task_head];
+		task_head = (task_head + 1) % (TIMER_TASKS_MAX + 1);
+		task->state = TASK_RUNNING;
+	}
+	__set_PRIMASK(primask);
+	return task;
+}
+
+/*
+ * \brief task_timeout_expired() is the callback of the timeout which resumes
+ * the task waiting in task_wait_timeout().
+ *
+ * \param none
+ * \return none
+ */
+
+static void task_timeout_expired (void)
+{
+	timer_task_t *task = task_timeout_waiter;
+
+	task_timeout_waiter = NULL;
+	if (task) {
+		task_push(task);
+	}
+}
+
+/*
+ * \brief task_timeout_check() resumes the task waiting for the timeout with
+ * result 1 if the application has taken over CCU41 in the meantime, e.g. by
+ * timeout_ms(), so the waiter is not left behind forever.
+ *
+ * \param none
+ * \return none
+ */
+
+static void task_timeout_check (void)
+{
+	timer_task_t *task = task_timeout_waiter;
+
+	if (task && (function_adress != task_timeout_expired)) {
+		task_timeout_waiter = NULL;
+		task->result = 1;
+		task_push(task);
+	}
+}
+
+/*
+ * \brief CCU42_0_IRQHandler() CCU42 interrupt handler which is called on 
+ * every task period. Within the interrupt service routine the tasks waiting
+ * for task periods are counted down and put into the ready queue once their
+ * wait has elapsed.
+ *
+ * \param none
+ * \return none
+ */
+
+void CCU42_0_IRQHandler (void)
+{
+	uint8_t i;
+
+	for (i = 0; i < TIMER_TASKS_MAX; i++) {
+		if ((task_pool[i].state == TASK_WAIT_PERIOD) && 
+		    (--task_pool[i].periods == 0)) {
+			task_push(&task_pool[i]);
+		}
+	}
+	task_timeout_check();
+}
+
+/*
+ * \brief setup_task() function is called by the main-routine. Within this 
+ * function the CCU42 unit is configured to raise the task period.
+ *
+ * \param uint32_t period_us task period in microseconds
+ * \return true if the task configuration was successful, or false if the 
+ * period is out of range.
+ */
+
+_Bool setup_task (uint32_t period_us)
+{
+	if (configure_timer_task (timer_us_to_ticks (period_us)) == false) {
+		return false;
+	}
+	task_period_us = period_us;
+	return true;
+}
+
+/*
+ * \brief task_create() takes a task from the static pool and puts it into the
+ * ready queue. The task function is first entered by the next task_run().
+ *
+ * \param void (*func)(timer_task_t *task) task function
+ * \param void *arg task context
+ * \return the task, or NULL if the pool is exhausted.
+ */
+
+timer_task_t *task_create (void (* func) (timer_task_t *task), void *arg)
+{
+	uint8_t i;
+
+	for (i = 0; i < TIMER_TASKS_MAX; i++) {
+		if (task_pool[i].state == TASK_FREE) {
+			task_pool[i].func = func;
+			task_pool[i].arg = arg;
+			task_pool[i].line = 0;
+			task_pool[i].result = 0;
+			task_pool[i].periods = 0;
+			task_push(&task_pool[i]);
+			return &task_pool[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+ * \brief task_run() is called within the main loop. The tasks which are in 
+ * the ready queue on entry are resumed at their last await point. Tasks which
+ * become ready meanwhile, also by TASK_YIELD(), are left for the next call, so
+ * task_run() returns even if a task yields in a loop.
+ *
+ * \param none
+ * \return none
+ */
+
+void task_run (void)
+{
+	const uint8_t tail = task_tail;
+	timer_task_t *task;
+
+	//Only task_pop() moves the head, the queue can not overtake the snapshot
+	while ((task_head != tail) && ((task = task_pop()) != NULL)) {
+		task->func(task);
+	}
+}
+
+/*
+ * \brief task_ready() puts a task back into the ready queue, so it is resumed
+ * by the next task_run().
+ *
+ * \param timer_task_t *task task to be resumed
+ * \return none
+ */
+
+void task_ready (timer_task_t *task)
+{
+	task->result = 0;
+	task_push(task);
+}
+
+/*
+ * \brief task_wait_periods() lets a task wait for a number of task periods.
+ * If setup_task() has not been called, the task is resumed immediately with
+ * result 1.
+ *
+ * \param timer_task_t *task waiting task
+ * \param uint32_t periods number of task periods, 0 resumes immediately
+ * \return none
+ */
+
+void task_wait_periods (timer_task_t *task, uint32_t periods)
+{
+	//Without setup_task() no task period is raised
+	task->result = (task_period_us == 0);
+	if ((periods == 0) || task->result) {
+		task_push(task);
+		return;
+	}
+	task->periods = periods;
+	task->state = TASK_WAIT_PERIOD;
+}
+
+/*
+ * \brief task_wait_delay() lets a task wait for at least ms milliseconds,
+ * rounded up to full task periods. If setup_task() has not been called, the
+ * task is resumed immediately with result 1.
+ *
+ * \param timer_task_t *task waiting task
+ * \param uint32_t ms delay in milliseconds
+ * \return none
+ */
+
+void task_wait_delay (timer_task_t *task, uint32_t ms)
+{
+	uint64_t us = (uint64_t) ms * 1000;
+
+	if (task_period_us == 0) {
+		task_wait_periods (task, 1);
+		return;
+	}
+	task_wait_periods (task, (us + task_period_us - 1) / task_period_us);
+}
+
+/*
+ * \brief task_wait_timeout() lets a task wait for the CCU41 timeout. Only one
+ * task can wait for the timeout at a time, and the timeout is only taken if
+ * CCU41 is idle. If it is in use by a task or the application, or it can not
+ * be started, the task is resumed immediately with result 1. If the 
+ * application starts its own timeout while a task waits, the task is resumed
+ * with result 1 on the next task period.
+ *
+ * \param timer_task_t *task waiting task
+ * \param uint32_t ms timeout in milliseconds
+ * \return none
+ */
+
+void task_wait_timeout (timer_task_t *task, uint32_t ms)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	task_timeout_check();
+	//The task period must not see the waiter before the callback is set
+	__disable_irq();
+	if ((task_timeout_waiter == NULL) && (timer_running (&timer_timeout) == false)) {
+		task_timeout_waiter = task;
+		task->result = 0;
+		task->state = TASK_WAIT_TIMEOUT;
+		if (timeout_ms (ms, task_timeout_expired) == 0) {
+			__set_PRIMASK(primask);
+			return;
+		}
+		task_timeout_waiter = NULL;
+	}
+	__set_PRIMASK(primask);
+	task->result = 1;
+	task_push(task);
+}
+
+/*
+ * \brief task_wait_pwm_period() sets the duty cycle of the task period output
+ * (CCU42.OUT0) and lets the task wait for the end of the running PWM period.
+ * The task is resumed as the new duty cycle becomes active, so a task which
+ * awaits in a loop sets one duty cycle per PWM period.
+ *
+ * \param timer_task_t *task waiting task
+ * \param uint8_t percent duty cycle in percent, limited to 100
+ * \return none
+ */
+
+void task_wait_pwm_period (timer_task_t *task, uint8_t percent)
+{
+	if (task_period_us) {
+		timer_task_duty (percent);
+	}
+	task_wait_periods (task, 1);
+}
+
+/* EOF */
@@ -0,0 +1,79 @@
+/*
+ * xmc4500_timer_task.h
+ */
+
+#ifndef INC_XMC4500_TIMER_TASK_H_
+#define INC_XMC4500_TIMER_TASK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************** DEFINES */
+#define TIMER_TASKS_MAX         8       //Size of the static task pool
+
+#define TASK_FREE               0
+#define TASK_READY              1
+#define TASK_RUNNING            2
+#define TASK_WAIT_PERIOD        3
+#define TASK_WAIT_TIMEOUT       4
+
+/*
+ * Cooperative task. The task function is re-entered by task_run() and jumps
+ * to the last await point, so variables which must survive an await have to
+ * be kept in the task context (arg) instead of on the stack. The jump is a 
+ * switch on the line of the await, so a task can not await from within a 
+ * switch statement of its own, and only one await fits on a line. C++20 code
+ * can use the coroutines of xmc4500_timer_task.hpp instead.
+ */
+typedef struct timer_task timer_task_t;
+
+struct timer_task {
+	void              (* func )( timer_task_t *task );
+	void               *arg;
+	uint16_t            line;       //Resume point
+	volatile uint8_t    state;
+	uint8_t             result;     //0 if the last await succeeded, 1 if not
+	volatile uint32_t   periods;    //Remaining task periods to wait
+};
+
+/********************************************************************* MACROS */
+#define TASK_BEGIN(task)        switch ((task)->line) { case 0:
+
+#define TASK_END(task)          } (task)->state = TASK_FREE; return
+
+#define TASK_AWAIT(task, wait)                                                \
+	do {                                                                  \
+		(task)->line = __LINE__;                                      \
+		wait;                                                         \
+		return;                                                       \
+		case __LINE__: ;                                              \
+	} while (0)
+
+#define TASK_YIELD(task)            TASK_AWAIT(task, task_ready (task))
+#define TASK_AWAIT_PERIOD(task)     TASK_AWAIT(task, task_wait_periods (task, 1))
+#define TASK_AWAIT_PERIODS(task, n) TASK_AWAIT(task, task_wait_periods (task, n))
+#define TASK_AWAIT_DELAY(task, ms)  TASK_AWAIT(task, task_wait_delay (task, ms))
+#define TASK_AWAIT_TIMEOUT(task, ms) TASK_AWAIT(task, task_wait_timeout (task, ms))
+#define TASK_AWAIT_PWM_PERIOD(task, percent) TASK_AWAIT(task, task_wait_pwm_period (task, percent))
+
+/******************************************************** FUNCTION PROTOTYPES */
+_Bool setup_task (uint32_t period_us);
+
+timer_task_t *task_create (void (* func )( timer_task_t *task ), void *arg);
+void task_run (void);
+
+void task_ready (timer_task_t *task);
+void task_wait_periods (timer_task_t *task, uint32_t periods);
+void task_wait_delay (timer_task_t *task, uint32_t ms);
+void task_wait_timeout (timer_task_t *task, uint32_t ms);
+void task_wait_pwm_period (timer_task_t *task, uint8_t percent);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_XMC4500_TIMER_TASK_H_ */
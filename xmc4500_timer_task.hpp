@@ -0,0 +1,217 @@
+/*
+ * xmc4500_timer_task.hpp
+ *
+ *  C++20 front-end of the cooperative tasks. A task is a coroutine returning
+ *  timer::task which awaits the hooks of xmc4500_timer_task.h:
+ *
+ *      timer::task blink (uint32_t ms)
+ *      {
+ *          for (uint8_t i = 0; i < 10; i++) {
+ *              co_await timer::delay (ms);
+ *          }
+ *      }
+ *      ...
+ *      timer::spawn (blink (100));
+ *
+ *  Each coroutine runs on a task of the C pool and is resumed by task_run()
+ *  like the tasks of the TASK_ macros. Unlike those, a coroutine keeps its
+ *  local variables across an await and may await anywhere, also within a
+ *  switch statement or several times on one line. The frame holding the
+ *  locals is taken from a static pool of TIMER_TASKS_MAX frames of
+ *  TIMER_FRAME_SIZE bytes, there is no heap. A coroutine whose frame does not
+ *  fit is not created and spawn() returns NULL. Coroutines are created and
+ *  spawned in the main loop only, not from interrupt service routines.
+ */
+
+#ifndef INC_XMC4500_TIMER_TASK_HPP_
+#define INC_XMC4500_TIMER_TASK_HPP_
+
+#include <coroutine>
+#include <cstddef>
+#include <utility>
+#include <xmc4500_timer_task.h>
+
+/******************************************************************** DEFINES */
+#ifndef TIMER_FRAME_SIZE
+#define TIMER_FRAME_SIZE        256     //Bytes of one coroutine frame
+#endif
+
+namespace timer {
+
+/*
+ * Static pool of coroutine frames, one per task of the C pool.
+ */
+class frame_pool {
+public:
+	static void *take (std::size_t size) noexcept
+	{
+		uint8_t i;
+
+		if (size > TIMER_FRAME_SIZE) {
+			return NULL;
+		}
+		for (i = 0; i < TIMER_TASKS_MAX; i++) {
+			if (used[i] == false) {
+				used[i] = true;
+				return frames[i];
+			}
+		}
+		return NULL;
+	}
+
+	static void give (void *frame) noexcept
+	{
+		used[(static_cast<unsigned char *>(frame) - frames[0]) / TIMER_FRAME_SIZE] = false;
+	}
+
+private:
+	alignas(std::max_align_t) static inline unsigned char frames[TIMER_TASKS_MAX][TIMER_FRAME_SIZE];
+	static inline bool used[TIMER_TASKS_MAX];
+};
+
+/*
+ * Return type of a task coroutine. The coroutine starts suspended and runs
+ * from the first task_run() after spawn(). A task which is never spawned
+ * releases its frame when it goes out of scope.
+ */
+class task {
+public:
+	struct promise_type {
+		timer_task_t *self = NULL;      //Task of the C pool running the coroutine
+
+		task get_return_object () noexcept
+		{
+			return task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+		static task get_return_object_on_allocation_failure () noexcept
+		{
+			return task(NULL);
+		}
+		std::suspend_always initial_suspend () noexcept { return {}; }
+		std::suspend_always final_suspend () noexcept { return {}; }
+		void return_void () noexcept {}
+		void unhandled_exception () noexcept {}
+
+		static void *operator new (std::size_t size) noexcept
+		{
+			return frame_pool::take(size);
+		}
+		static void operator delete (void *frame) noexcept
+		{
+			frame_pool::give(frame);
+		}
+	};
+
+	task (task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	task (const task &) = delete;
+	task &operator= (const task &) = delete;
+	~task ()
+	{
+		if (handle) {
+			handle.destroy();
+		}
+	}
+
+	friend timer_task_t *spawn (task coroutine);
+
+private:
+	explicit task (std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+	explicit task (std::nullptr_t) noexcept : handle(nullptr) {}
+
+	/*
+	 * \brief resume() is the C task function of every coroutine. It resumes the
+	 * coroutine at its last co_await and frees the frame and the task once the
+	 * coroutine has returned.
+	 */
+	static void resume (timer_task_t *self)
+	{
+		auto handle = std::coroutine_handle<promise_type>::from_address(self->arg);
+
+		handle.resume();
+		if (handle.done()) {
+			handle.destroy();
+			self->state = TASK_FREE;
+		}
+	}
+
+	std::coroutine_handle<promise_type> handle;
+};
+
+/*
+ * \brief spawn() hands a coroutine to a task of the C pool and puts it into
+ * the ready queue.
+ *
+ * \param task coroutine the result of calling a task coroutine
+ * \return the task, or NULL if the frame or the task pool is exhausted.
+ */
+
+inline timer_task_t *spawn (task coroutine)
+{
+	timer_task_t *self;
+
+	if (!coroutine.handle) {
+		return NULL;
+	}
+	self = task_create(task::resume, coroutine.handle.address());
+	if (self == NULL) {
+		return NULL;
+	}
+	coroutine.handle.promise().self = self;
+	coroutine.handle = nullptr;
+	return self;
+}
+
+/*
+ * Awaiter of one task_wait_*() hook. co_await suspends the coroutine, calls
+ * the hook with the task of the coroutine and yields the result of the wait,
+ * 0 if it succeeded and 1 if not.
+ */
+class wait {
+public:
+	wait (void (* hook) (timer_task_t *task, uint32_t arg), uint32_t arg) noexcept
+		: hook(hook), arg(arg) {}
+
+	bool await_ready () const noexcept { return false; }
+	void await_suspend (std::coroutine_handle<task::promise_type> handle) noexcept
+	{
+		self = handle.promise().self;
+		hook(self, arg);
+	}
+	uint8_t await_resume () const noexcept { return self->result; }
+
+private:
+	void (* hook) (timer_task_t *task, uint32_t arg);
+	uint32_t arg;
+	timer_task_t *self = NULL;
+};
+
+inline wait yield () noexcept
+{
+	return wait([] (timer_task_t *task, uint32_t) { task_ready(task); }, 0);
+}
+
+inline wait periods (uint32_t n) noexcept
+{
+	return wait(task_wait_periods, n);
+}
+
+inline wait delay (uint32_t ms) noexcept
+{
+	return wait(task_wait_delay, ms);
+}
+
+inline wait timeout (uint32_t ms) noexcept
+{
+	return wait(task_wait_timeout, ms);
+}
+
+inline wait pwm_period (uint8_t percent) noexcept
+{
+	return wait([] (timer_task_t *task, uint32_t arg) {
+		task_wait_pwm_period(task, static_cast<uint8_t>(arg));
+	}, percent);
+}
+
+} /* namespace timer */
+
+#endif /* INC_XMC4500_TIMER_TASK_HPP_ */